@@ -187,9 +187,10 @@ if [ "$build_hdf5" = true ]; then
     ./autogen.sh || exit 1
 
     # If we are building the tools with REST VOL support, link in the already built
-    # REST VOL library, along with cURL and YAJL.
+    # REST VOL library, along with cURL and YAJL. H5_HAVE_REST_VOL enables the
+    # REST VOL I/O API in the h5perf_serial and h5perf benchmarks.
     if [ "${build_tools}" = true ]; then
-        ./configure --prefix="${HDF5_INSTALL_DIR}" CFLAGS="${COMP_OPTS} -L${INSTALL_DIR}/lib ${REST_VOL_LINK} ${CURL_LINK} ${YAJL_LINK}" || exit 1
+        ./configure --prefix="${HDF5_INSTALL_DIR}" CFLAGS="${COMP_OPTS} -DH5_HAVE_REST_VOL -I${INSTALL_DIR}/include -L${INSTALL_DIR}/lib ${REST_VOL_LINK} ${CURL_LINK} ${YAJL_LINK}" || exit 1
     else
         ./configure --prefix="${HDF5_INSTALL_DIR}" CFLAGS="${COMP_OPTS}" || exit 1
     fi
@@ -42,6 +42,10 @@
 
 #include "pio_perf.h"
 
+#ifdef H5_HAVE_REST_VOL
+#include "rest_vol_public.h"
+#endif
+
 /* Macro definitions */
 
 #if H5_VERS_MAJOR == 1 && H5_VERS_MINOR == 6
@@ -124,6 +128,8 @@ typedef union _file_descr {
 /* local functions */
 static char  *pio_create_filename(iotype iot, const char *base_name,
     char *fullname, size_t size);
+static char  *pio_create_domain_name(const char *base_name, char *fullname,
+    size_t size);
 static herr_t do_write(results *res, file_descr *fd, parameters *parms,
     long ndsets, off_t nelmts, size_t buf_size, void *buffer);
 static herr_t do_read(results *res, file_descr *fd, parameters *parms,
@@ -183,6 +189,7 @@ do_pio(parameters param)
             res.timers = io_time_new(MPI_CLOCK);
             break;
         case PHDF5:
+        case RESTVOL:
             fd.h5fd = -1;
             res.timers = io_time_new(MPI_CLOCK);
             break;
@@ -373,6 +380,7 @@ done:
             hrc = do_fclose(iot, &fd);
             break;
         case PHDF5:
+        case RESTVOL:
             if (fd.h5fd != -1)
             hrc = do_fclose(iot, &fd);
             break;
@@ -417,6 +425,8 @@ pio_create_filename(iotype iot, const char *base_name, char *fullname, size_t si
         case PHDF5:
             suffix = ".h5";
             break;
+        case RESTVOL:
+            return pio_create_domain_name(base_name, fullname, size);
     }
 
     /* First use the environment variable and then try the constant */
@@ -501,6 +511,53 @@ pio_create_filename(iotype iot, const char *base_name, char *fullname, size_t si
     return fullname;
 }
 
+/*
+ * Function:    pio_create_domain_name
+ * Purpose:     Create the HSDS domain to write to for the REST VOL. The
+ *              domain is placed in the folder named by HSDS_PREFIX, or
+ *              else in the /home/$HSDS_USERNAME folder. Characters that
+ *              can't appear in a domain's URL are dropped from the base
+ *              name.
+ * Return:      Pointer to domain name or NULL
+ */
+    static char *
+pio_create_domain_name(const char *base_name, char *fullname, size_t size)
+{
+    const char *prefix, *user;
+    size_t i;
+    int len;
+
+    if ((prefix = HDgetenv("HSDS_PREFIX")) && *prefix)
+        len = HDsnprintf(fullname, size, "%s%s", prefix,
+                         prefix[HDstrlen(prefix) - 1] == '/' ? "" : "/");
+    else if ((user = HDgetenv("HSDS_USERNAME")) && *user)
+        len = HDsnprintf(fullname, size, "/home/%s/", user);
+    else {
+        fprintf(stderr, "Neither HSDS_PREFIX nor HSDS_USERNAME is set\n");
+        return NULL;
+    }
+
+    if (len < 0 || (size_t)len >= size)
+        return NULL;
+
+    for (i = (size_t)len; *base_name; base_name++) {
+        if (*base_name == '#' || *base_name == '?' || *base_name == '/')
+            continue;
+
+        if (i + 1 >= size)
+            return NULL;
+
+        fullname[i++] = *base_name;
+    }
+
+    if (i + 3 >= size)
+        return NULL;
+
+    HDstrcpy(fullname + i, ".h5");
+
+    return fullname;
+}
+
 /*
  * Function:        do_write
  * Purpose:         Write the required amount of data to the file.
@@ -607,7 +664,7 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
         else {
             bytes_begin[0] = 0;
 
-            if(!parms->h5_use_chunks || parms->io_type==PHDF5)
+            if(!parms->h5_use_chunks || parms->io_type==PHDF5 || parms->io_type==RESTVOL)
                 bytes_begin[1] = (off_t)(blk_size*pio_mpi_rank_g);
             else
                 bytes_begin[1] = (off_t)(blk_size*blk_size*pio_mpi_rank_g);
@@ -745,6 +802,7 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
         break;
 
     case PHDF5: /* HDF5 setup */
+    case RESTVOL:
         /* 1D dataspace */
         if (!parms->dim2d){
             if(nbytes>0) {
@@ -853,7 +911,7 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
         }
 
         /* Change to collective I/O, if asked */
-        if(parms->collective) {
+        if(parms->collective && parms->io_type == PHDF5) {
             hrc = H5Pset_dxpl_mpio(h5dxpl, H5FD_MPIO_COLLECTIVE);
             if (hrc < 0) {
                 fprintf(stderr, "HDF5 Property List Set failed\n");
@@ -876,6 +934,7 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
             break;
 
         case PHDF5:
+        case RESTVOL:
             h5dcpl = H5Pcreate(H5P_DATASET_CREATE);
             if (h5dcpl < 0) {
                 fprintf(stderr, "HDF5 Property List Create failed\n");
@@ -909,8 +968,17 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
             }/* end else */
 
             sprintf(dname, "Dataset_%ld", ndset);
-            h5ds_id = H5DCREATE(fd->h5fd, dname, ELMT_H5_TYPE,
-                h5dset_space_id, h5dcpl);
+            if (parms->io_type == RESTVOL && pio_mpi_rank_g != 0) {
+                /* Wait for process 0 to create the dataset */
+                MPI_Barrier(pio_comm_g);
+                h5ds_id = H5DOPEN(fd->h5fd, dname);
+            }
+            else {
+                h5ds_id = H5DCREATE(fd->h5fd, dname, ELMT_H5_TYPE,
+                    h5dset_space_id, h5dcpl);
+                if (parms->io_type == RESTVOL)
+                    MPI_Barrier(pio_comm_g);
+            }
 
             if (h5ds_id < 0) {
                 fprintf(stderr, "HDF5 Dataset Create failed\n");
@@ -1327,6 +1395,7 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
             break;
 
         case PHDF5:
+        case RESTVOL:
             /* 1D dataspace */
             if (!parms->dim2d){
             /* Set up the file dset space id to move the selection to process */
@@ -1389,7 +1458,7 @@ do_write(results *res, file_descr *fd, parameters *parms, long ndsets,
     /* Calculate write time */
 
     /* Close dataset. Only HDF5 needs to do an explicit close. */
-    if (parms->io_type == PHDF5) {
+    if (parms->io_type == PHDF5 || parms->io_type == RESTVOL) {
         hrc = H5Dclose(h5ds_id);
 
         if (hrc < 0) {
@@ -1585,7 +1654,7 @@ do_read(results *res, file_descr *fd, parameters *parms, long ndsets,
         else {
             bytes_begin[0] = 0;
 
-            if (!parms->h5_use_chunks || parms->io_type==PHDF5)
+            if (!parms->h5_use_chunks || parms->io_type==PHDF5 || parms->io_type==RESTVOL)
                 bytes_begin[1] = (off_t)(blk_size*pio_mpi_rank_g);
             else
                 bytes_begin[1] = (off_t)(blk_size*blk_size*pio_mpi_rank_g);
@@ -1716,6 +1785,7 @@ do_read(results *res, file_descr *fd, parameters *parms, long ndsets,
         break;
 
     case PHDF5: /* HDF5 setup */
+    case RESTVOL:
         /* 1D dataspace */
         if (!parms->dim2d){
         if(nbytes>0) {
@@ -1824,7 +1894,7 @@ do_read(results *res, file_descr *fd, parameters *parms, long ndsets,
         }
 
         /* Change to collective I/O, if asked */
-        if(parms->collective) {
+        if(parms->collective && parms->io_type == PHDF5) {
         hrc = H5Pset_dxpl_mpio(h5dxpl, H5FD_MPIO_COLLECTIVE);
         if (hrc < 0) {
             fprintf(stderr, "HDF5 Property List Set failed\n");
@@ -1847,6 +1917,7 @@ do_read(results *res, file_descr *fd, parameters *parms, long ndsets,
         break;
 
         case PHDF5:
+        case RESTVOL:
         sprintf(dname, "Dataset_%ld", ndset);
         h5ds_id = H5DOPEN(fd->h5fd, dname);
         if (h5ds_id < 0) {
@@ -2256,6 +2327,7 @@ do_read(results *res, file_descr *fd, parameters *parms, long ndsets,
             break;
 
         case PHDF5:
+        case RESTVOL:
             /* 1D dataspace */
             if (!parms->dim2d){
             /* Set up the file dset space id to move the selection to process */
@@ -2344,7 +2416,7 @@ do_read(results *res, file_descr *fd, parameters *parms, long ndsets,
     /* Calculate read time */
 
     /* Close dataset. Only HDF5 needs to do an explicit close. */
-    if (parms->io_type == PHDF5) {
+    if (parms->io_type == PHDF5 || parms->io_type == RESTVOL) {
         hrc = H5Dclose(h5ds_id);
 
         if (hrc < 0) {
@@ -2536,6 +2608,47 @@ do_fopen(parameters *param, char *fname, file_descr *fd /*out*/, int flags)
             }
 
             break;
+
+        case RESTVOL:
+#ifdef H5_HAVE_REST_VOL
+            if ((acc_tpl = H5Pcreate(H5P_FILE_ACCESS)) < 0) {
+                fprintf(stderr, "HDF5 Property List Create failed\n");
+                GOTOERROR(FAIL);
+            }
+
+            if (H5Pset_fapl_rest_vol(acc_tpl) < 0) {
+                fprintf(stderr, "HDF5 Property List Set failed\n");
+                GOTOERROR(FAIL);
+            }
+
+            /* The REST VOL has no notion of the other processes, so process
+             * 0 alone creates the domain and the rest open it afterwards */
+            if (flags & (PIO_CREATE | PIO_WRITE)) {
+                if (pio_mpi_rank_g == 0)
+                    fd->h5fd = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, acc_tpl);
+
+                MPI_Barrier(pio_comm_g);
+
+                if (pio_mpi_rank_g != 0)
+                    fd->h5fd = H5Fopen(fname, H5F_ACC_RDWR, acc_tpl);
+            }
+            else
+                fd->h5fd = H5Fopen(fname, H5F_ACC_RDONLY, acc_tpl);
+            if (fd->h5fd < 0) {
+                fprintf(stderr, "REST VOL File Create failed(%s)\n", fname);
+                GOTOERROR(FAIL);
+            }
+
+            /* verifying the close of the acc_tpl */
+            if (H5Pclose(acc_tpl) < 0) {
+                fprintf(stderr, "HDF5 Property List Close failed\n");
+                GOTOERROR(FAIL);
+            }
+#else
+            fprintf(stderr, "Not built with REST VOL support\n");
+            GOTOERROR(FAIL);
+#endif
+            break;
     }
 
 done:
@@ -2579,6 +2692,7 @@ do_fclose(iotype iot, file_descr *fd /*out*/)
         break;
 
     case PHDF5:
+    case RESTVOL:
         hrc = H5Fclose(fd->h5fd);
 
         if (hrc < 0) {
@@ -2622,6 +2736,10 @@ do_cleanupfile(iotype iot, char *fname)
         case PHDF5:
         MPI_File_delete(fname, h5_io_info_g);
         break;
+        case RESTVOL:
+        /* The domain is left in place on the server; the next run's
+         * H5Fcreate() with H5F_ACC_TRUNC replaces it */
+        break;
     }
     }
 }
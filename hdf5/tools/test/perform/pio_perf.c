@@ -48,6 +48,9 @@
  *
  *          . . .
  *
+ *      IO API = REST VOL
+ *          . . .
+ *
  *  nprocs = Max#Procs / 2
  *
  *      . . .
@@ -69,6 +72,10 @@
 /* our header files */
 #include "pio_perf.h"
 
+#ifdef H5_HAVE_REST_VOL
+#include "rest_vol_public.h"
+#endif
+
 /* useful macros */
 #define TAB_SPACE           4
 
@@ -79,6 +86,7 @@
 #define PIO_POSIX           0x1
 #define PIO_MPI             0x2
 #define PIO_HDF5            0x4
+#define PIO_RESTVOL         0x8
 
 /* report 0.0 in case t is zero too */
 #define MB_PER_SEC(bytes,t) (((t)==0.0) ? 0.0 : ((((double)bytes) / ONE_MB) / (t)))
@@ -385,8 +393,21 @@ main(int argc, char **argv)
     if ((pio_debug_level == 0 && comm_world_rank_g == 0) || pio_debug_level > 0)
         report_parameters(opts);
 
+#ifdef H5_HAVE_REST_VOL
+    if ((opts->io_types & PIO_RESTVOL) && RVinit() < 0) {
+        fprintf(stderr, "%s: cannot initialize the REST VOL\n", progname);
+        exit_value = EXIT_FAILURE;
+        goto finish;
+    }
+#endif
+
     run_test_loop(opts);
 
+#ifdef H5_HAVE_REST_VOL
+    if (opts->io_types & PIO_RESTVOL)
+        RVterm();
+#endif
+
 finish:
     MPI_Finalize();
     free(opts);
@@ -402,7 +423,8 @@ finish:
  *              number by 2 and rerun the test.
  *
  *            - The second slowest is what type of IO API to perform. We have
- *              three choices: POSIXIO, MPI-IO, and PHDF5.
+ *              four choices: POSIXIO, MPI-IO, PHDF5, and HDF5 through
+ *              the REST VOL.
  *
  *            - Then we change the size of the buffer. This information is
  *              inferred from the number of datasets to create and the number
@@ -492,6 +514,9 @@ run_test_loop(struct options *opts)
                 if (opts->io_types & PIO_HDF5)
                     run_test(PHDF5, parms, opts);
 
+                if (opts->io_types & PIO_RESTVOL)
+                    run_test(RESTVOL, parms, opts);
+
                 /* Run the tests once if buf_size==0, but then break out */
                 if(buf_size==0)
                     break;
@@ -558,6 +583,9 @@ run_test(iotype iot, parameters parms, struct options *opts)
         case PHDF5:
             output_report("PHDF5 (w/MPI-IO driver)\n");
             break;
+        case RESTVOL:
+            output_report("REST VOL\n");
+            break;
     }
 
     MPI_Comm_size(pio_comm_g, &comm_size);
@@ -1120,6 +1148,8 @@ print_io_api(long io_types)
 	HDfprintf(output, "mpiio ");
     if (io_types & PIO_HDF5)
 	HDfprintf(output, "phdf5 ");
+    if (io_types & PIO_RESTVOL)
+	HDfprintf(output, "rest ");
     HDfprintf(output, "\n");
 }
 
@@ -1231,6 +1261,16 @@ report_parameters(struct options *opts)
                   (prefix ? prefix : "not set"));
     }
 
+    if (opts->io_types & PIO_RESTVOL) {
+        char *endpoint = HDgetenv("HSDS_ENDPOINT");
+        char *prefix = HDgetenv("HSDS_PREFIX");
+
+        HDfprintf(output, "rank %d: Env HSDS_ENDPOINT=%s\n", rank,
+                  (endpoint ? endpoint : "not set"));
+        HDfprintf(output, "rank %d: Env HSDS_PREFIX=%s\n", rank,
+                  (prefix ? prefix : "not set"));
+    }
+
     HDfprintf(output, "rank %d: ", rank);
     h5_dump_info_object(h5_io_info_g);
 
@@ -1302,6 +1342,13 @@ parse_command_line(int argc, char *argv[])
                         cl_opts->io_types |= PIO_MPI;
                     } else if (!HDstrcasecmp(buf, "posix")) {
                         cl_opts->io_types |= PIO_POSIX;
+                    } else if (!HDstrcasecmp(buf, "rest")) {
+#ifdef H5_HAVE_REST_VOL
+                        cl_opts->io_types |= PIO_RESTVOL;
+#else
+                        fprintf(stderr, "pio_perf: not built with REST VOL support\n");
+                        exit(EXIT_FAILURE);
+#endif
                     } else {
                         fprintf(stderr, "pio_perf: invalid --api option %s\n",
                                 buf);
@@ -1607,6 +1654,8 @@ usage(const char *prog)
         printf("          phdf5 - Parallel HDF5\n");
         printf("          mpiio - MPI-I/O\n");
         printf("          posix - POSIX\n");
+        printf("          rest - HDF5 through the REST VOL, against the HSDS instance\n");
+        printf("                 at $HSDS_ENDPOINT (only when built with REST VOL support)\n");
         printf("\n");
         printf("      Example: --api=mpiio,phdf5\n");
         printf("\n");
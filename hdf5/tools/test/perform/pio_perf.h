@@ -30,7 +30,8 @@
 typedef enum iotype_ {
     POSIXIO,
     MPIO,
-    PHDF5
+    PHDF5,
+    RESTVOL
     /*NUM_TYPES*/
 } iotype;
 
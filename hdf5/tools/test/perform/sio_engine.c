@@ -34,6 +34,10 @@
 
 #include "sio_perf.h"
 
+#ifdef H5_HAVE_REST_VOL
+#include "rest_vol_public.h"
+#endif
+
 /* Macro definitions */
 
 /* sizes of various items. these sizes won't change during program execution */
@@ -81,6 +85,8 @@ typedef union _file_descr {
 /* local functions */
 static char  *sio_create_filename(iotype iot, const char *base_name,
     char *fullname, size_t size, parameters *param);
+static char  *sio_create_domain_name(const char *base_name, char *fullname,
+    size_t size);
 static herr_t do_write(results *res, file_descr *fd, parameters *parms, void *buffer);
 static herr_t do_read(results *res, file_descr *fd, parameters *parms, void *buffer);
 static herr_t dset_write(int local_dim, file_descr *fd, parameters *parms, void *buffer);
@@ -148,6 +154,7 @@ do_sio(parameters param, results *res)
         res->timers = io_time_new(SYS_CLOCK);
         break;
     case HDF5:
+    case RESTVOL:
         fd.h5fd = -1;
         res->timers = io_time_new(SYS_CLOCK);
         break;
@@ -256,6 +263,7 @@ done:
                 hrc = do_fclose(iot, &fd);
             break;
         case HDF5:
+        case RESTVOL:
             if (fd.h5fd != -1)
                 hrc = do_fclose(iot, &fd);
 			break;
@@ -307,6 +315,8 @@ sio_create_filename(iotype iot, const char *base_name, char *fullname, size_t si
         else if (vfd == multi)
             suffix = NULL;
         break;
+    case RESTVOL:
+        return sio_create_domain_name(base_name, fullname, size);
     default:
         /* unknown request */
         HDfprintf(stderr, "Unknown IO type request (%d)\n", (int)iot);
@@ -392,6 +402,53 @@ sio_create_filename(iotype iot, const char *base_name, char *fullname, size_t si
     return fullname;
 }
 
+/*
+ * Function:    sio_create_domain_name
+ * Purpose:     Create the HSDS domain to write to for the REST VOL. The
+ *              domain is placed in the folder named by HSDS_PREFIX, or
+ *              else in the /home/$HSDS_USERNAME folder. Characters that
+ *              can't appear in a domain's URL are dropped from the base
+ *              name.
+ * Return:      Pointer to domain name or NULL
+ */
+    static char *
+sio_create_domain_name(const char *base_name, char *fullname, size_t size)
+{
+    const char *prefix, *user;
+    size_t i;
+    int len;
+
+    if ((prefix = HDgetenv("HSDS_PREFIX")) && *prefix)
+        len = HDsnprintf(fullname, size, "%s%s", prefix,
+                         prefix[HDstrlen(prefix) - 1] == '/' ? "" : "/");
+    else if ((user = HDgetenv("HSDS_USERNAME")) && *user)
+        len = HDsnprintf(fullname, size, "/home/%s/", user);
+    else {
+        HDfprintf(stderr, "Neither HSDS_PREFIX nor HSDS_USERNAME is set\n");
+        return NULL;
+    }
+
+    if (len < 0 || (size_t)len >= size)
+        return NULL;
+
+    for (i = (size_t)len; *base_name; base_name++) {
+        if (*base_name == '#' || *base_name == '?' || *base_name == '/')
+            continue;
+
+        if (i + 1 >= size)
+            return NULL;
+
+        fullname[i++] = *base_name;
+    }
+
+    if (i + 3 >= size)
+        return NULL;
+
+    HDstrcpy(fullname + i, ".h5");
+
+    return fullname;
+}
+
 /*
  * Function:        do_write
  * Purpose:         Write the required amount of data to the file.
@@ -452,6 +509,7 @@ do_write(results *res, file_descr *fd, parameters *parms, void *buffer)
         break;
 
     case HDF5: /* HDF5 setup */
+    case RESTVOL:
 
         for (i=0; i < rank; i++){
             h5dims[i] = parms->dset_size[i];
@@ -503,6 +561,7 @@ do_write(results *res, file_descr *fd, parameters *parms, void *buffer)
         break;
 
         case HDF5:
+        case RESTVOL:
             h5dcpl = H5Pcreate(H5P_DATASET_CREATE);
 
         if (h5dcpl < 0) {
@@ -561,7 +620,7 @@ do_write(results *res, file_descr *fd, parameters *parms, void *buffer)
     /* Calculate write time */
 
     /* Close dataset. Only HDF5 needs to do an explicit close. */
-    if (parms->io_type == HDF5) {
+    if (parms->io_type == HDF5 || parms->io_type == RESTVOL) {
         hrc = H5Dclose(h5ds_id);
 
         if (hrc < 0) {
@@ -650,6 +709,7 @@ dset_write(int local_dim, file_descr *fd, parameters *parms, void *buffer)
                 break;
 
             case HDF5:
+            case RESTVOL:
                 /* if dimensions are extendable, extend them as needed during access */
                 if (parms->h5_use_chunks && parms->h5_extendable) {
 
@@ -809,6 +869,7 @@ do_read(results *res, file_descr *fd, parameters *parms, void *buffer)
         break;
 
     case HDF5: /* HDF5 setup */
+    case RESTVOL:
         for (i=0; i < rank; i++){
             h5dims[i] = parms->dset_size[i];
             h5start[i] = 0;
@@ -850,6 +911,7 @@ do_read(results *res, file_descr *fd, parameters *parms, void *buffer)
         break;
 
         case HDF5:
+        case RESTVOL:
         sprintf(dname, "Dataset_%ld", (long)parms->num_bytes);
         h5ds_id = H5Dopen2(fd->h5fd, dname, H5P_DEFAULT);
         if (h5ds_id < 0) {
@@ -880,7 +942,7 @@ do_read(results *res, file_descr *fd, parameters *parms, void *buffer)
     /* Calculate read time */
 
     /* Close dataset. Only HDF5 needs to do an explicit close. */
-    if (parms->io_type == HDF5) {
+    if (parms->io_type == HDF5 || parms->io_type == RESTVOL) {
         hrc = H5Dclose(h5ds_id);
 
         if (hrc < 0) {
@@ -974,6 +1036,7 @@ dset_read(int local_dim, file_descr *fd, parameters *parms, void *buffer,
                 break;
 
             case HDF5:
+            case RESTVOL:
                 hrc = H5Soffset_simple(h5dset_space_id, h5offset);
                 VRFY((hrc >= 0), "H5Soffset_simple");
                 /* Read the buffer out */
@@ -1108,7 +1171,37 @@ do_fopen(parameters *param, char *fname, file_descr *fd /*out*/, int flags)
             GOTOERROR(FAIL);
         }
         break;
-		
+
+    case RESTVOL:
+#ifdef H5_HAVE_REST_VOL
+        fapl = H5Pcreate(H5P_FILE_ACCESS);
+
+        if (fapl < 0 || H5Pset_fapl_rest_vol(fapl) < 0) {
+            fprintf(stderr, "HDF5 Property List Create failed\n");
+            GOTOERROR(FAIL);
+        }
+
+        /* The file driver and page aggregation options don't apply to an
+         * HSDS domain, so the file is created with the default properties */
+        if (flags & (SIO_CREATE | SIO_WRITE)) {
+            fd->h5fd = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+        } else {
+            fd->h5fd = H5Fopen(fname, H5F_ACC_RDONLY, fapl);
+        }
+
+        H5Pclose(fapl);
+        fapl = -1;
+
+        if (fd->h5fd < 0) {
+            fprintf(stderr, "REST VOL File Create failed(%s)\n", fname);
+            GOTOERROR(FAIL);
+        }
+#else
+        HDfprintf(stderr, "Not built with REST VOL support\n");
+        GOTOERROR(FAIL);
+#endif
+        break;
+
     default:
         /* unknown request */
         HDfprintf(stderr, "Unknown IO type request (%d)\n", (int)param->io_type);
@@ -1227,6 +1320,7 @@ do_fclose(iotype iot, file_descr *fd /*out*/)
         break;
 
     case HDF5:
+    case RESTVOL:
         hrc = H5Fclose(fd->h5fd);
 
         if (hrc < 0) {
@@ -1308,7 +1402,12 @@ do_cleanupfile(iotype iot, char *filename)
             }
             H5Pclose(fapl);
         break;
-			
+
+    case RESTVOL:
+        /* The domain is left in place on the server; the next run's
+         * H5Fcreate() with H5F_ACC_TRUNC replaces it */
+        break;
+
     default:
         /* unknown request */
         HDfprintf(stderr, "Unknown IO type request (%d)\n", (int)iot);
@@ -40,6 +40,10 @@
  *          . . .
  *
  *
+ *      IO API = REST VOL
+ *          . . .
+ *
+ *
  *      . . .
  *
  */
@@ -51,6 +55,9 @@
 
 #include "hdf5.h"
 
+#ifdef H5_HAVE_REST_VOL
+#include "rest_vol_public.h"
+#endif
 
 /* our header files */
 #include "sio_perf.h"
@@ -64,6 +71,7 @@
 
 #define SIO_POSIX           0x1
 #define SIO_HDF5            0x4
+#define SIO_RESTVOL         0x8
 
 /* report 0.0 in case t is zero too */
 #define MB_PER_SEC(bytes,t) (H5_DBL_ABS_EQUAL(t, (double)0.0F) ? (double)0.0F : ((((double)bytes) / (double)ONE_MB) / (t)))
@@ -353,8 +361,21 @@ main(int argc, char **argv)
 
     report_parameters(opts);
 
+#ifdef H5_HAVE_REST_VOL
+    if ((opts->io_types & SIO_RESTVOL) && RVinit() < 0) {
+        fprintf(stderr, "%s: cannot initialize the REST VOL\n", progname);
+        exit_value = EXIT_FAILURE;
+        goto finish;
+    }
+#endif
+
     run_test_loop(opts);
 
+#ifdef H5_HAVE_REST_VOL
+    if (opts->io_types & SIO_RESTVOL)
+        RVterm();
+#endif
+
 finish:
     free(opts);
     return exit_value;
@@ -369,7 +390,7 @@ finish:
  *              number by 2 and rerun the test.
  *
  *            - The second slowest is what type of IO API to perform. We have
- *              three choices: POSIXIO, and HDF5.
+ *              three choices: POSIXIO, HDF5, and HDF5 through the REST VOL.
  *
  *            - Then we change the size of the buffer. This information is
  *              inferred from the number of datasets to create and the number
@@ -426,6 +447,10 @@ run_test_loop(struct options *opts)
     print_indent(0);
     if (opts->io_types & SIO_HDF5)
         run_test(HDF5, parms, opts);
+
+    print_indent(0);
+    if (opts->io_types & SIO_RESTVOL)
+        run_test(RESTVOL, parms, opts);
 }
 
 /*
@@ -470,6 +495,9 @@ run_test(iotype iot, parameters parms, struct options *opts)
         case HDF5:
             output_report("HDF5\n");
             break;
+        case RESTVOL:
+            output_report("REST VOL\n");
+            break;
         default:
             /* unknown request */
             HDfprintf(stderr, "Unknown IO type request (%d)\n", (int)iot);
@@ -836,6 +864,8 @@ print_io_api(long io_types)
 	HDfprintf(output, "posix ");
     if (io_types & SIO_HDF5)
 	HDfprintf(output, "hdf5 ");
+    if (io_types & SIO_RESTVOL)
+	HDfprintf(output, "rest ");
     HDfprintf(output, "\n");
 }
 
@@ -881,7 +911,7 @@ report_parameters(struct options *opts)
         recover_size_and_print((long long)opts->order[i], " ");
     HDfprintf(output, "\n");
 
-    if (opts->io_types & SIO_HDF5) {
+    if (opts->io_types & (SIO_HDF5 | SIO_RESTVOL)) {
 
         HDfprintf(output, "HDF5 data storage method=");
 
@@ -904,7 +934,9 @@ report_parameters(struct options *opts)
         else {
             HDfprintf(output, "Contiguous\n");
         }
+    }
 
+    if (opts->io_types & SIO_HDF5) {
         HDfprintf(output, "HDF5 file driver=");
         if (opts->vfd==sec2) {
             HDfprintf(output, "sec2\n");
@@ -930,6 +962,16 @@ report_parameters(struct options *opts)
                   (prefix ? prefix : "not set"));
     }
 
+    if (opts->io_types & SIO_RESTVOL) {
+        char *endpoint = HDgetenv("HSDS_ENDPOINT");
+        char *prefix = HDgetenv("HSDS_PREFIX");
+
+        HDfprintf(output, "Env HSDS_ENDPOINT=%s\n",
+                  (endpoint ? endpoint : "not set"));
+        HDfprintf(output, "Env HSDS_PREFIX=%s\n",
+                  (prefix ? prefix : "not set"));
+    }
+
     HDfprintf(output, "==== End of Parameters ====\n");
     HDfprintf(output, "\n");
 }
@@ -1011,6 +1053,13 @@ parse_command_line(int argc, char *argv[])
                         cl_opts->io_types |= SIO_HDF5;
                     } else if (!HDstrcasecmp(buf, "posix")) {
                         cl_opts->io_types |= SIO_POSIX;
+                    } else if (!HDstrcasecmp(buf, "rest")) {
+#ifdef H5_HAVE_REST_VOL
+                        cl_opts->io_types |= SIO_RESTVOL;
+#else
+                        fprintf(stderr, "sio_perf: not built with REST VOL support\n");
+                        exit(EXIT_FAILURE);
+#endif
                     } else {
                         fprintf(stderr, "sio_perf: invalid --api option %s\n",
                                 buf);
@@ -1393,6 +1442,8 @@ usage(const char *prog)
         printf("  AL - is an API list. Valid values are:\n");
         printf("          hdf5 - HDF5\n");
         printf("          posix - POSIX\n");
+        printf("          rest - HDF5 through the REST VOL, against the HSDS instance\n");
+        printf("                 at $HSDS_ENDPOINT (only when built with REST VOL support)\n");
         printf("\n");
         printf("      Example: -A posix,hdf5\n");
         printf("\n");
@@ -31,7 +31,8 @@
 
 typedef enum iotype_ {
     POSIXIO,
-    HDF5
+    HDF5,
+    RESTVOL
     /*NUM_TYPES*/
 } iotype;
 
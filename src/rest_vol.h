@@ -31,6 +31,7 @@ extern "C" {
 #include <yajl/yajl_tree.h>
 
 #include "rest_vol_public.h"
+#include "H5Spublic.h"
 
 #define HDF5_VOL_REST_VERSION 1 /* Version number of the REST VOL plugin */
 
@@ -62,11 +63,66 @@ extern "C" {
 
 typedef struct RV_object_t RV_object_t;
 
+/* A rectangular block of dataset elements whose write to the server has
+ * been deferred while write-back buffering is active for the dataset's
+ * file. The block's data is stored in row-major order.
+ */
+typedef struct RV_write_block_t RV_write_block_t;
+struct RV_write_block_t {
+    hsize_t           start[H5S_MAX_RANK];
+    hsize_t           count[H5S_MAX_RANK];
+    size_t            data_size;
+    size_t            data_nalloc;
+    void             *data;
+    RV_write_block_t *next;
+};
+
+/* The set of pending writes for a dataset while write-back buffering is
+ * active. Datasets with a write buffer are chained together on their
+ * file object so that all of a file's pending writes can be flushed
+ * during H5Fflush and H5Fclose. When a dataset is extended by an append
+ * while buffering is active, only the dataset's cached dataspace is
+ * updated and the new shape is sent to the server ahead of the buffered
+ * data when the buffer is next flushed.
+ */
+typedef struct RV_write_buffer_t {
+    hid_t             mem_type_id;
+    size_t            buffered_bytes;
+    hbool_t           flushing;
+    hbool_t           extent_pending;
+    RV_write_block_t *blocks;
+    RV_object_t      *next_dataset;
+} RV_write_buffer_t;
+
+/* The kinds of request that the request headers kept for each domain are
+ * prepared for. Every list of headers holds the domain's X-Hdf-domain
+ * header and an empty Expect header, which stops cURL from waiting for a
+ * 100 Continue response, along with the Content-Type or Accept header
+ * for its kind of request.
+ */
+typedef enum {
+    RV_REQUEST_HEADERS_DEFAULT,
+    RV_REQUEST_HEADERS_SEND_JSON,
+    RV_REQUEST_HEADERS_SEND_BINARY,
+    RV_REQUEST_HEADERS_ACCEPT_JSON,
+    RV_REQUEST_HEADERS_ACCEPT_BINARY,
+    RV_REQUEST_HEADERS_NTYPES
+} RV_request_headers_t;
+
 typedef struct RV_file_t {
-    unsigned  intent;
-    char     *filepath_name;
-    hid_t     fcpl_id;
-    hid_t     fapl_id;
+    unsigned           intent;
+    char              *filepath_name;
+    hid_t              fcpl_id;
+    hid_t              fapl_id;
+    size_t             write_buffer_size;
+    RV_object_t       *write_buffered_datasets;
+    char              *disk_cache_dir;
+    size_t             disk_cache_max_size;
+
+    /* The headers for requests made on the domain, which are built the first
+     * time each kind is needed and reused until the file is closed
+     */
+    struct curl_slist *request_headers[RV_REQUEST_HEADERS_NTYPES];
 } RV_file_t;
 
 typedef struct RV_group_t {
@@ -75,10 +131,20 @@ typedef struct RV_group_t {
 } RV_group_t;
 
 typedef struct RV_dataset_t {
-    hid_t space_id;
-    hid_t dtype_id;
-    hid_t dcpl_id;
-    hid_t dapl_id;
+    hid_t              space_id;
+    hid_t              dtype_id;
+    hid_t              dcpl_id;
+    hid_t              dapl_id;
+    RV_write_buffer_t *write_buffer;
+
+    /* The time the dataset was last modified on the server as of when it
+     * was opened, or 0 if unknown. Reads are only served from the disk
+     * cache while this is known, so it is reset by writes to the dataset.
+     * Writes through other handles to the same dataset are detected by
+     * comparing cache_generation against the dataset's current write count.
+     */
+    double             last_modified;
+    size_t             cache_generation;
 } RV_dataset_t;
 
 typedef struct RV_attr_t {
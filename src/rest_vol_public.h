@@ -23,6 +23,8 @@
 #ifndef rest_vol_public_H
 #define rest_vol_public_H
 
+#include <stdint.h>
+
 #include "H5public.h"
 #include "H5Rpublic.h"
 #include "H5PLextern.h"
@@ -79,16 +81,219 @@ extern "C" {
 #define FILTER_NAME_MAX_LENGTH                        256
 #define FILTER_MAX_CD_VALUES                          32
 
+/* Maximum length of the path of the directory used for the disk cache
+ * of dataset reads set with H5Pset_fapl_rest_vol_disk_cache().
+ */
+#define DISK_CACHE_DIR_MAX_LENGTH 1024
+
+/* Maximum length of the comma-separated list of server endpoints set
+ * with H5Pset_fapl_rest_vol_endpoints().
+ */
+#define ENDPOINTS_MAX_LENGTH 4096
+
+/* How requests are spread over the endpoints of a server which has more
+ * than one. Under RV_ENDPOINT_LEAST_OUTSTANDING, each request goes to the
+ * endpoint with the fewest requests in flight. Under RV_ENDPOINT_HASH,
+ * all requests for the same object go to the same endpoint, which keeps
+ * the object in that server node's cache.
+ */
+typedef enum rv_endpoint_policy_t {
+    RV_ENDPOINT_LEAST_OUTSTANDING = 0,
+    RV_ENDPOINT_HASH
+} rv_endpoint_policy_t;
+
+/* The compression applied to the binary data of dataset reads and writes
+ * while in transit, as set with H5Pset_dxpl_rest_vol_compression(). The
+ * data can also be byte-shuffled before compression, which groups the
+ * bytes of the elements together by significance and often lets smoothly
+ * varying numerical data compress much further. The server must support
+ * the same content encodings.
+ */
+typedef enum rv_compression_t {
+    RV_COMPRESSION_NONE = 0,
+    RV_COMPRESSION_DEFLATE,
+    RV_COMPRESSION_ZSTD
+} rv_compression_t;
+
+/* The priority class of the requests for dataset reads and writes, as set
+ * with H5Pset_dxpl_rest_vol_priority(). When the plugin makes several
+ * requests at once, interactive requests are started ahead of those for
+ * small transfers, which are in turn favored over bulk transfers, while
+ * each class is limited in how many of its requests can be in flight.
+ * By default, each transfer is classed as small or bulk by its size.
+ * Metadata requests are not scheduled by class.
+ */
+typedef enum rv_priority_t {
+    RV_PRIORITY_AUTO = 0,
+    RV_PRIORITY_INTERACTIVE,
+    RV_PRIORITY_SMALL,
+    RV_PRIORITY_BULK
+} rv_priority_t;
+
+/* An object reference. Rather than holding a copy of the referenced
+ * object's URI, each reference holds the index of the URI in a table of
+ * URIs kept by the plugin, which can be retrieved with RVget_ref_uri().
+ * References remain valid until RVterm() is called. A zeroed reference
+ * doesn't refer to any object.
+ */
 typedef struct rv_obj_ref_t {
     H5R_type_t ref_type;
     H5I_type_t ref_obj_type;
-    char       ref_obj_URI[URI_MAX_LENGTH];
+    size_t     ref_obj_URI_index;
 } rv_obj_ref_t;
 
+/* Dataset operations specific to the REST VOL, which are made through the
+ * VOL's dataset "optional" callback. The operation arguments, following the
+ * operation type, are those of the corresponding RVdataset_*() call, with
+ * the dataset ID and the DXPL omitted.
+ */
+typedef enum rv_dataset_optional_t {
+    RV_DATASET_READ_MULTI = 1024,   /* RVdataset_read_multi  */
+    RV_DATASET_WRITE_MULTI,         /* RVdataset_write_multi */
+    RV_DATASET_QUERY                /* RVdataset_query       */
+} rv_dataset_optional_t;
+
+/* The elements of a dataset which matched a query made with
+ * RVdataset_query(), in order of their index in the dataset. The
+ * buffers are allocated by the plugin and must be released with
+ * RVquery_result_free().
+ */
+typedef struct rv_query_result_t {
+    size_t   nmatches;
+    hsize_t *indices;
+    void    *values;
+} rv_query_result_t;
+
+/* The kinds of REST operation for which the plugin keeps separate request
+ * statistics.
+ */
+typedef enum rv_request_type_t {
+    RV_REQUEST_DATASET_VALUE_GET = 0,   /* GET of a dataset's values        */
+    RV_REQUEST_DATASET_VALUE_PUT,       /* PUT of a dataset's values        */
+    RV_REQUEST_DATASET_VALUE_POST,      /* POST of a dataset's values       */
+    RV_REQUEST_LINK,                    /* Any request on a group's links   */
+    RV_REQUEST_ATTRIBUTE,               /* Any request on an attribute      */
+    RV_REQUEST_OBJECT_GET,              /* Any other GET of an object       */
+    RV_REQUEST_OTHER,                   /* Everything else                  */
+    RV_REQUEST_NTYPES                   /* Must be last                     */
+} rv_request_type_t;
+
+/* The number of buckets in each request latency histogram. Latencies are
+ * recorded in microseconds, with a relative error of at most 25%.
+ */
+#define RV_STATS_LATENCY_NBUCKETS 128
+
+/* Statistics for one kind of request made to the server. Requests which
+ * failed to get any HTTP response are counted in num_failed; all others
+ * are counted in num_status by the class of their HTTP status code
+ * (1xx through 5xx). Requests which had to open a new connection rather
+ * than reuse one are counted in num_connects. Times are in microseconds.
+ */
+typedef struct rv_request_stats_t {
+    uint64_t num_requests;
+    uint64_t num_failed;
+    uint64_t num_status[5];
+    uint64_t num_connects;
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint64_t total_time_us;
+    uint64_t connect_time_us;
+    uint64_t handshake_time_us;
+    uint64_t server_time_us;
+    uint64_t transfer_time_us;
+    uint64_t max_latency_us;
+    uint64_t latency_histogram[RV_STATS_LATENCY_NBUCKETS];
+} rv_request_stats_t;
+
+/* The plugin's request statistics, as retrieved with RVget_stats(). The
+ * statistics are kept from the last call to RVinit() or RVreset_stats().
+ */
+typedef struct rv_stats_t {
+    uint64_t           num_retries;
+    uint64_t           num_hedges;
+    rv_request_stats_t requests[RV_REQUEST_NTYPES];
+} rv_stats_t;
+
+/* A request made by the plugin, as passed to a loopback request handler
+ * set with RVset_loopback_handler(). The path is still URL-encoded and
+ * the query is given without its leading '?'. The domain, content type
+ * and accepted type are the values of the request's X-Hdf-domain,
+ * Content-Type and Accept headers. Any of these which the request
+ * doesn't have are NULL.
+ */
+typedef struct rv_loopback_request_t {
+    const char *method;
+    const char *path;
+    const char *query;
+    const char *domain;
+    const char *content_type;
+    const char *accept;
+    const char *body;
+    size_t      body_len;
+} rv_loopback_request_t;
+
+/* A loopback request handler's response to a request. The body remains
+ * owned by the handler and only needs to stay valid until the handler is
+ * next called or the plugin is terminated. A NULL content type is taken
+ * to be "application/json".
+ */
+typedef struct rv_loopback_response_t {
+    long        status;
+    const char *content_type;
+    const char *body;
+    size_t      body_len;
+} rv_loopback_response_t;
+
+/* A function which serves the plugin's requests in the same process, in
+ * place of a server, for measuring the plugin's own overhead and for
+ * testing without a network. Returns non-negative if it responded to the
+ * request, or negative if it couldn't, which fails the request as if the
+ * server couldn't be reached.
+ */
+typedef herr_t (*rv_loopback_handler_t)(const rv_loopback_request_t *request, rv_loopback_response_t *response,
+                                        void *handler_data);
+
 H5PLUGIN_DLL herr_t      RVinit(void);
 H5PLUGIN_DLL herr_t      RVterm(void);
 H5PLUGIN_DLL herr_t      H5Pset_fapl_rest_vol(hid_t fapl_id);
+H5PLUGIN_DLL herr_t      H5Pset_fapl_rest_vol_write_buffer(hid_t fapl_id, size_t buf_size);
+H5PLUGIN_DLL herr_t      H5Pget_fapl_rest_vol_write_buffer(hid_t fapl_id, size_t *buf_size);
+H5PLUGIN_DLL herr_t      H5Pset_fapl_rest_vol_disk_cache(hid_t fapl_id, const char *cache_dir, size_t max_size);
+H5PLUGIN_DLL herr_t      H5Pget_fapl_rest_vol_disk_cache(hid_t fapl_id, char *cache_dir, size_t cache_dir_size, size_t *max_size);
+H5PLUGIN_DLL herr_t      H5Pset_fapl_rest_vol_endpoints(hid_t fapl_id, const char *endpoint_list, rv_endpoint_policy_t policy);
+H5PLUGIN_DLL herr_t      H5Pget_fapl_rest_vol_endpoints(hid_t fapl_id, char *endpoint_list, size_t endpoints_size,
+                                                        rv_endpoint_policy_t *policy);
+H5PLUGIN_DLL herr_t      H5Pset_dxpl_rest_vol_compression(hid_t dxpl_id, rv_compression_t compression, hbool_t shuffle,
+                                                          size_t min_size);
+H5PLUGIN_DLL herr_t      H5Pget_dxpl_rest_vol_compression(hid_t dxpl_id, rv_compression_t *compression, hbool_t *shuffle,
+                                                          size_t *min_size);
+H5PLUGIN_DLL herr_t      H5Pset_dxpl_rest_vol_retry(hid_t dxpl_id, unsigned max_retries, double backoff,
+                                                    double hedge_percentile);
+H5PLUGIN_DLL herr_t      H5Pget_dxpl_rest_vol_retry(hid_t dxpl_id, unsigned *max_retries, double *backoff,
+                                                    double *hedge_percentile);
+H5PLUGIN_DLL herr_t      H5Pset_dxpl_rest_vol_deadline(hid_t dxpl_id, double timeout);
+H5PLUGIN_DLL herr_t      H5Pget_dxpl_rest_vol_deadline(hid_t dxpl_id, double *timeout);
+H5PLUGIN_DLL herr_t      H5Pset_dxpl_rest_vol_priority(hid_t dxpl_id, rv_priority_t priority);
+H5PLUGIN_DLL herr_t      H5Pget_dxpl_rest_vol_priority(hid_t dxpl_id, rv_priority_t *priority);
+H5PLUGIN_DLL herr_t      H5Pset_dxpl_rest_vol_read_window(hid_t dxpl_id, size_t window_size, unsigned num_buffers);
+H5PLUGIN_DLL herr_t      H5Pget_dxpl_rest_vol_read_window(hid_t dxpl_id, size_t *window_size, unsigned *num_buffers);
 H5PLUGIN_DLL const char *RVget_uri(hid_t);
+H5PLUGIN_DLL const char *RVget_ref_uri(const rv_obj_ref_t *ref);
+H5PLUGIN_DLL herr_t      RVdataset_append(hid_t dset_id, hid_t dxpl_id, unsigned axis, size_t extension,
+                                         hid_t mem_type_id, const void *buf);
+H5PLUGIN_DLL herr_t      RVdataset_read_multi(size_t count, const hid_t dset_ids[], const hid_t mem_type_ids[],
+                                             const hid_t mem_space_ids[], const hid_t file_space_ids[], hid_t dxpl_id,
+                                             void *bufs[], herr_t statuses[]);
+H5PLUGIN_DLL herr_t      RVdataset_write_multi(size_t count, const hid_t dset_ids[], const hid_t mem_type_ids[],
+                                              const hid_t mem_space_ids[], const hid_t file_space_ids[], hid_t dxpl_id,
+                                              const void *bufs[], herr_t statuses[]);
+H5PLUGIN_DLL herr_t      RVdataset_query(hid_t dset_id, const char *query, hid_t mem_type_id, hid_t dxpl_id,
+                                        rv_query_result_t *result);
+H5PLUGIN_DLL herr_t      RVquery_result_free(rv_query_result_t *result);
+H5PLUGIN_DLL herr_t      RVget_stats(rv_stats_t *stats);
+H5PLUGIN_DLL herr_t      RVreset_stats(void);
+H5PLUGIN_DLL herr_t      RVset_loopback_handler(rv_loopback_handler_t handler, void *handler_data);
+H5PLUGIN_DLL uint64_t    RVstats_latency_percentile(const rv_request_stats_t *req_stats, double percentile);
 
 #ifdef __cplusplus
 }
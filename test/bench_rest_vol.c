@@ -0,0 +1,727 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5. The full HDF5 copyright notice, including      *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic document set and is     *
+ * linked from the top-level documents page.  It can also be found at        *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have access   *
+ * to either file, you may request a copy from help@hdfgroup.org.            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: End-to-end throughput benchmarks for the REST VOL plugin.
+ *
+ *          Unless an endpoint is given, the benchmarks run against the
+ *          in-memory mock HSDS server, started in-process with the
+ *          requested latency and bandwidth, so that results are
+ *          reproducible and only measure the plugin and the HTTP stack.
+ *          With --loopback, the plugin's requests are instead passed
+ *          straight to the mock server's request handler in-process,
+ *          leaving out the HTTP stack and sockets as well, so that only
+ *          the plugin's own overhead is measured.
+ *
+ *          Measured are dataset read and write throughput for several
+ *          selection shapes and sizes, batched reads of multiple datasets,
+ *          and the rate of metadata operations (group/dataset creation and
+ *          opening, attribute creation and reads, link iteration and
+ *          visiting). Results are printed as a table and can additionally be
+ *          written out as JSON with --output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hdf5.h"
+#include "rest_vol_public.h"
+#include "rest_vol_mock_hsds.h"
+
+#define BENCH_FILE_NAME_DEFAULT  "/home/bench/bench_rest_vol.h5"
+#define BENCH_ITERATIONS_DEFAULT 5
+#define BENCH_OBJECTS_DEFAULT    256
+#define BENCH_NUM_POINTS         1024
+#define BENCH_MULTI_COUNT        8
+#define BENCH_NAME_LENGTH        64
+
+typedef enum {
+    BENCH_SEL_ALL,
+    BENCH_SEL_ROW_BLOCK,
+    BENCH_SEL_COLUMN_BLOCK,
+    BENCH_SEL_STRIDED,
+    BENCH_SEL_POINTS,
+    BENCH_SEL_NTYPES
+} bench_sel_t;
+
+static const char * const sel_names[BENCH_SEL_NTYPES] = {
+    "all", "row_block", "column_block", "strided", "points"
+};
+
+static const size_t default_sizes[] = { 64 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+static const size_t quick_sizes[]   = { 64 * 1024, 1024 * 1024 };
+
+static struct {
+    const char *endpoint;
+    const char *filename;
+    const char *output;
+    uint64_t    latency_us;
+    uint64_t    bandwidth;
+    int         iterations;
+    size_t      num_objects;
+    int         quick;
+    int         loopback;
+    FILE       *json;
+    int         num_results;
+    int         num_failures;
+
+    rv_mock_hsds_response_t loopback_response;
+} bench;
+
+static double
+bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+static uint64_t
+bench_num_requests(void)
+{
+    rv_stats_t stats;
+    uint64_t   total = 0;
+    size_t     i;
+
+    if (RVget_stats(&stats) < 0)
+        return 0;
+
+    for (i = 0; i < RV_REQUEST_NTYPES; i++)
+        total += stats.requests[i].num_requests;
+
+    return total;
+}
+
+static void
+bench_report(const char *benchmark, const char *variant, size_t size, size_t ops,
+    double bytes, double seconds, uint64_t requests)
+{
+    double mib_per_sec = seconds > 0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0;
+    double ops_per_sec = seconds > 0 ? (double) ops / seconds : 0;
+
+    printf("%-18s %-14s %10zu %8zu %10.4f %12.2f %12.1f %10llu\n",
+           benchmark, variant, size, ops, seconds, mib_per_sec, ops_per_sec, (unsigned long long) requests);
+
+    if (bench.json)
+        fprintf(bench.json,
+                "%s\n    {\"benchmark\": \"%s\", \"variant\": \"%s\", \"size_bytes\": %zu, \"ops\": %zu, "
+                "\"bytes\": %.0f, \"seconds\": %.6f, \"MiB_per_sec\": %.3f, \"ops_per_sec\": %.3f, "
+                "\"requests\": %llu}",
+                bench.num_results ? "," : "", benchmark, variant, size, ops, bytes, seconds,
+                mib_per_sec, ops_per_sec, (unsigned long long) requests);
+
+    bench.num_results++;
+}
+
+/* Builds the file dataspace selection for an n x n dataset */
+static hid_t
+bench_make_selection(bench_sel_t sel, hsize_t n, hsize_t *nelmts)
+{
+    hsize_t  dims[2] = { n, n };
+    hsize_t  start[2], stride[2], count[2];
+    hsize_t *coords = NULL;
+    hid_t    space_id;
+    size_t   i;
+
+    if ((space_id = H5Screate_simple(2, dims, NULL)) < 0)
+        return -1;
+
+    switch (sel) {
+        case BENCH_SEL_ALL:
+            *nelmts = n * n;
+            return space_id;
+
+        /* A contiguous band of rows */
+        case BENCH_SEL_ROW_BLOCK:
+            start[0] = n / 4; start[1] = 0;
+            count[0] = n / 2; count[1] = n;
+            stride[0] = stride[1] = 1;
+            break;
+
+        /* A band of columns, which is non-contiguous in the dataset */
+        case BENCH_SEL_COLUMN_BLOCK:
+            start[0] = 0; start[1] = n / 4;
+            count[0] = n; count[1] = n / 2;
+            stride[0] = stride[1] = 1;
+            break;
+
+        /* Every other element in both dimensions */
+        case BENCH_SEL_STRIDED:
+            start[0] = start[1] = 0;
+            count[0] = count[1] = n / 2;
+            stride[0] = stride[1] = 2;
+            break;
+
+        case BENCH_SEL_POINTS:
+        {
+            size_t   npoints = (n * n < BENCH_NUM_POINTS) ? (size_t) (n * n) : BENCH_NUM_POINTS;
+            unsigned seed = 12345;
+
+            if (NULL == (coords = (hsize_t *) malloc(2 * npoints * sizeof(*coords))))
+                goto error;
+
+            /* Spread the points over the dataset; duplicates are harmless for timing */
+            for (i = 0; i < npoints; i++) {
+                seed = seed * 1103515245u + 12345u;
+                coords[2 * i] = (hsize_t) ((seed >> 8) % n);
+                seed = seed * 1103515245u + 12345u;
+                coords[2 * i + 1] = (hsize_t) ((seed >> 8) % n);
+            }
+
+            if (H5Sselect_elements(space_id, H5S_SELECT_SET, npoints, coords) < 0)
+                goto error;
+
+            free(coords);
+            *nelmts = npoints;
+            return space_id;
+        }
+
+        case BENCH_SEL_NTYPES:
+        default:
+            goto error;
+    }
+
+    if (H5Sselect_hyperslab(space_id, H5S_SELECT_SET, start, stride, count, NULL) < 0)
+        goto error;
+
+    *nelmts = count[0] * count[1];
+
+    return space_id;
+
+error:
+    free(coords);
+    H5Sclose(space_id);
+    return -1;
+}
+
+/* Times writes and reads of each selection shape on an n x n dataset of
+ * roughly the given size in bytes
+ */
+static int
+bench_dataset_io(hid_t file_id, size_t size)
+{
+    hsize_t  n = 2;
+    hsize_t  dims[2];
+    hid_t    dset_id = -1, fspace_id = -1, mspace_id = -1;
+    char     name[BENCH_NAME_LENGTH];
+    int     *wbuf = NULL, *rbuf = NULL;
+    size_t   sel, i;
+    int      it;
+
+    while ((n + 2) * (n + 2) * sizeof(int) <= size)
+        n += 2;
+    dims[0] = dims[1] = n;
+
+    snprintf(name, sizeof(name), "io_%zu", size);
+
+    if ((fspace_id = H5Screate_simple(2, dims, NULL)) < 0)
+        goto error;
+    if ((dset_id = H5Dcreate2(file_id, name, H5T_NATIVE_INT, fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        goto error;
+    H5Sclose(fspace_id);
+    fspace_id = -1;
+
+    if (NULL == (wbuf = (int *) malloc(n * n * sizeof(int))) || NULL == (rbuf = (int *) malloc(n * n * sizeof(int))))
+        goto error;
+
+    for (sel = 0; sel < BENCH_SEL_NTYPES; sel++) {
+        hsize_t  nelmts;
+        uint64_t requests;
+        double   start_time, seconds;
+
+        if ((fspace_id = bench_make_selection((bench_sel_t) sel, n, &nelmts)) < 0)
+            goto error;
+        if ((mspace_id = H5Screate_simple(1, &nelmts, NULL)) < 0)
+            goto error;
+
+        for (i = 0; i < nelmts; i++)
+            wbuf[i] = (int) (sel * 1000003 + i);
+
+        requests = bench_num_requests();
+        start_time = bench_now();
+        for (it = 0; it < bench.iterations; it++) {
+            if (H5Dwrite(dset_id, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, wbuf) < 0)
+                goto error;
+            if (H5Dflush(dset_id) < 0)
+                goto error;
+        }
+        seconds = bench_now() - start_time;
+        bench_report("dataset_write", sel_names[sel], size, (size_t) bench.iterations,
+                     (double) bench.iterations * (double) (nelmts * sizeof(int)), seconds,
+                     bench_num_requests() - requests);
+
+        requests = bench_num_requests();
+        start_time = bench_now();
+        for (it = 0; it < bench.iterations; it++)
+            if (H5Dread(dset_id, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, rbuf) < 0)
+                goto error;
+        seconds = bench_now() - start_time;
+        bench_report("dataset_read", sel_names[sel], size, (size_t) bench.iterations,
+                     (double) bench.iterations * (double) (nelmts * sizeof(int)), seconds,
+                     bench_num_requests() - requests);
+
+        /* Random point selections may repeat a point, so only hyperslabs
+         * are guaranteed to read back exactly what was written
+         */
+        if (sel != BENCH_SEL_POINTS && memcmp(wbuf, rbuf, nelmts * sizeof(int))) {
+            fprintf(stderr, "data read back from '%s' with selection '%s' didn't match data written\n",
+                    name, sel_names[sel]);
+            bench.num_failures++;
+        }
+
+        H5Sclose(mspace_id);
+        mspace_id = -1;
+        H5Sclose(fspace_id);
+        fspace_id = -1;
+    }
+
+    free(wbuf);
+    free(rbuf);
+    H5Dclose(dset_id);
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+    } H5E_END_TRY;
+    free(wbuf);
+    free(rbuf);
+
+    return -1;
+}
+
+/* Compares reading several datasets one at a time against a single
+ * batched RVdataset_read_multi() call
+ */
+static int
+bench_multi_read(hid_t file_id, size_t size)
+{
+    hsize_t  nelmts = size / sizeof(int);
+    hid_t    dset_ids[BENCH_MULTI_COUNT];
+    hid_t    mem_type_ids[BENCH_MULTI_COUNT];
+    hid_t    all_spaces[BENCH_MULTI_COUNT];
+    hid_t    space_id = -1;
+    void    *bufs[BENCH_MULTI_COUNT];
+    char     name[BENCH_NAME_LENGTH];
+    uint64_t requests;
+    double   start_time, seconds;
+    size_t   i;
+    int      it;
+
+    for (i = 0; i < BENCH_MULTI_COUNT; i++) {
+        dset_ids[i] = -1;
+        bufs[i] = NULL;
+        mem_type_ids[i] = H5T_NATIVE_INT;
+        all_spaces[i] = H5S_ALL;
+    }
+
+    if ((space_id = H5Screate_simple(1, &nelmts, NULL)) < 0)
+        goto error;
+
+    for (i = 0; i < BENCH_MULTI_COUNT; i++) {
+        snprintf(name, sizeof(name), "multi_%zu_%zu", size, i);
+        if ((dset_ids[i] = H5Dcreate2(file_id, name, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            goto error;
+        if (NULL == (bufs[i] = calloc(nelmts, sizeof(int))))
+            goto error;
+        if (H5Dwrite(dset_ids[i], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, bufs[i]) < 0)
+            goto error;
+    }
+
+    requests = bench_num_requests();
+    start_time = bench_now();
+    for (it = 0; it < bench.iterations; it++)
+        for (i = 0; i < BENCH_MULTI_COUNT; i++)
+            if (H5Dread(dset_ids[i], H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, bufs[i]) < 0)
+                goto error;
+    seconds = bench_now() - start_time;
+    bench_report("multi_read", "sequential", size, (size_t) bench.iterations * BENCH_MULTI_COUNT,
+                 (double) bench.iterations * BENCH_MULTI_COUNT * (double) size, seconds,
+                 bench_num_requests() - requests);
+
+    requests = bench_num_requests();
+    start_time = bench_now();
+    for (it = 0; it < bench.iterations; it++)
+        if (RVdataset_read_multi(BENCH_MULTI_COUNT, dset_ids, mem_type_ids, all_spaces, all_spaces,
+                                 H5P_DEFAULT, bufs, NULL) < 0)
+            goto error;
+    seconds = bench_now() - start_time;
+    bench_report("multi_read", "batched", size, (size_t) bench.iterations * BENCH_MULTI_COUNT,
+                 (double) bench.iterations * BENCH_MULTI_COUNT * (double) size, seconds,
+                 bench_num_requests() - requests);
+
+    for (i = 0; i < BENCH_MULTI_COUNT; i++) {
+        H5Dclose(dset_ids[i]);
+        free(bufs[i]);
+    }
+    H5Sclose(space_id);
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        for (i = 0; i < BENCH_MULTI_COUNT; i++)
+            H5Dclose(dset_ids[i]);
+        H5Sclose(space_id);
+    } H5E_END_TRY;
+    for (i = 0; i < BENCH_MULTI_COUNT; i++)
+        free(bufs[i]);
+
+    return -1;
+}
+
+static herr_t
+bench_count_links(hid_t group_id, const char *name, const H5L_info_t *info, void *op_data)
+{
+    (void) group_id; (void) name; (void) info;
+
+    (*(size_t *) op_data)++;
+
+    return 0;
+}
+
+/* Times the rate of common metadata operations */
+static int
+bench_metadata(hid_t file_id)
+{
+    hid_t    group_id = -1, obj_id = -1, space_id = -1, attr_id = -1;
+    char     name[BENCH_NAME_LENGTH];
+    uint64_t requests;
+    double   start_time;
+    size_t   nlinks;
+    size_t   i;
+    int      value;
+
+    if ((group_id = H5Gcreate2(file_id, "meta", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+        goto error;
+    if ((space_id = H5Screate(H5S_SCALAR)) < 0)
+        goto error;
+
+#define BENCH_TIME_LOOP(benchmark, body)                                                          \
+    requests = bench_num_requests();                                                              \
+    start_time = bench_now();                                                                     \
+    for (i = 0; i < bench.num_objects; i++) {                                                     \
+        body                                                                                      \
+    }                                                                                             \
+    bench_report(benchmark, "-", 0, bench.num_objects, 0, bench_now() - start_time,               \
+                 bench_num_requests() - requests);
+
+    BENCH_TIME_LOOP("group_create",
+        snprintf(name, sizeof(name), "group_%06zu", i);
+        if ((obj_id = H5Gcreate2(group_id, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            goto error;
+        H5Gclose(obj_id);
+    )
+
+    BENCH_TIME_LOOP("group_open",
+        snprintf(name, sizeof(name), "group_%06zu", i);
+        if ((obj_id = H5Gopen2(group_id, name, H5P_DEFAULT)) < 0)
+            goto error;
+        H5Gclose(obj_id);
+    )
+
+    BENCH_TIME_LOOP("dataset_create",
+        snprintf(name, sizeof(name), "dataset_%06zu", i);
+        if ((obj_id = H5Dcreate2(group_id, name, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            goto error;
+        H5Dclose(obj_id);
+    )
+
+    BENCH_TIME_LOOP("dataset_open",
+        snprintf(name, sizeof(name), "dataset_%06zu", i);
+        if ((obj_id = H5Dopen2(group_id, name, H5P_DEFAULT)) < 0)
+            goto error;
+        H5Dclose(obj_id);
+    )
+
+    if ((obj_id = H5Dopen2(group_id, "dataset_000000", H5P_DEFAULT)) < 0)
+        goto error;
+
+    BENCH_TIME_LOOP("attribute_create",
+        snprintf(name, sizeof(name), "attr_%06zu", i);
+        value = (int) i;
+        if ((attr_id = H5Acreate2(obj_id, name, H5T_NATIVE_INT, space_id, H5P_DEFAULT, H5P_DEFAULT)) < 0)
+            goto error;
+        if (H5Awrite(attr_id, H5T_NATIVE_INT, &value) < 0)
+            goto error;
+        H5Aclose(attr_id);
+    )
+
+    BENCH_TIME_LOOP("attribute_read",
+        snprintf(name, sizeof(name), "attr_%06zu", i);
+        if ((attr_id = H5Aopen(obj_id, name, H5P_DEFAULT)) < 0)
+            goto error;
+        if (H5Aread(attr_id, H5T_NATIVE_INT, &value) < 0)
+            goto error;
+        H5Aclose(attr_id);
+    )
+
+#undef BENCH_TIME_LOOP
+
+    H5Dclose(obj_id);
+    obj_id = -1;
+
+    /* Iteration and visiting are single calls, so report them as links per second */
+    nlinks = 0;
+    requests = bench_num_requests();
+    start_time = bench_now();
+    if (H5Literate(group_id, H5_INDEX_NAME, H5_ITER_INC, NULL, bench_count_links, &nlinks) < 0)
+        goto error;
+    bench_report("link_iterate", "-", 0, nlinks, 0, bench_now() - start_time, bench_num_requests() - requests);
+
+    nlinks = 0;
+    requests = bench_num_requests();
+    start_time = bench_now();
+    if (H5Lvisit(file_id, H5_INDEX_NAME, H5_ITER_INC, bench_count_links, &nlinks) < 0)
+        goto error;
+    bench_report("link_visit", "-", 0, nlinks, 0, bench_now() - start_time, bench_num_requests() - requests);
+
+    H5Sclose(space_id);
+    H5Gclose(group_id);
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Aclose(attr_id);
+        H5Dclose(obj_id);
+        H5Gclose(obj_id);
+        H5Sclose(space_id);
+        H5Gclose(group_id);
+    } H5E_END_TRY;
+
+    return -1;
+}
+
+/* Serves the plugin's requests in-process with the mock server's request
+ * handler. The previous response is kept until the next request, as the
+ * plugin requires.
+ */
+static herr_t
+bench_loopback_handler(const rv_loopback_request_t *request, rv_loopback_response_t *response, void *handler_data)
+{
+    rv_mock_hsds_request_t mock_request;
+
+    rv_mock_hsds_free_response(&bench.loopback_response);
+
+    memset(&mock_request, 0, sizeof(mock_request));
+    mock_request.method = request->method;
+    mock_request.path = request->path;
+    mock_request.query = request->query;
+    mock_request.domain = request->domain;
+    mock_request.content_type = request->content_type;
+    mock_request.body = request->body;
+    mock_request.body_len = request->body_len;
+
+    if (rv_mock_hsds_handle_request((rv_mock_hsds_t *) handler_data, &mock_request, &bench.loopback_response) < 0)
+        return -1;
+
+    response->status = bench.loopback_response.status;
+    response->content_type = bench.loopback_response.content_type;
+    response->body = bench.loopback_response.body;
+    response->body_len = bench.loopback_response.body_len;
+
+    return 0;
+}
+
+static void
+usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [options]\n", prog);
+    fprintf(stderr, "  --endpoint URL      benchmark an existing server instead of the mock server\n");
+    fprintf(stderr, "  --file NAME         domain to create (default %s)\n", BENCH_FILE_NAME_DEFAULT);
+    fprintf(stderr, "  --latency-us N      mock server latency per request, in microseconds\n");
+    fprintf(stderr, "  --bandwidth N       mock server bandwidth limit, in bytes per second\n");
+    fprintf(stderr, "  --loopback          serve requests in-process, without sockets; the latency\n");
+    fprintf(stderr, "                      and bandwidth limits don't apply\n");
+    fprintf(stderr, "  --iterations N      repetitions of each transfer (default %d)\n", BENCH_ITERATIONS_DEFAULT);
+    fprintf(stderr, "  --objects N         objects per metadata benchmark (default %d)\n", BENCH_OBJECTS_DEFAULT);
+    fprintf(stderr, "  --quick             smaller sizes and object counts\n");
+    fprintf(stderr, "  --output FILE       also write the results as JSON to FILE\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    rv_mock_hsds_config_t  config;
+    rv_mock_hsds_stats_t   server_stats;
+    rv_mock_hsds_t        *server = NULL;
+    const size_t          *sizes;
+    size_t                 nsizes, i;
+    unsigned short         port;
+    char                   endpoint[64];
+    hid_t                  fapl_id = -1, file_id = -1;
+    int                    rv_initialized = 0;
+    int                    ret_value = 1;
+
+    bench.filename = BENCH_FILE_NAME_DEFAULT;
+    bench.iterations = BENCH_ITERATIONS_DEFAULT;
+    bench.num_objects = 0;
+
+    for (i = 1; i < (size_t) argc; i++) {
+        if (!strcmp(argv[i], "--endpoint") && i + 1 < (size_t) argc)
+            bench.endpoint = argv[++i];
+        else if (!strcmp(argv[i], "--file") && i + 1 < (size_t) argc)
+            bench.filename = argv[++i];
+        else if (!strcmp(argv[i], "--latency-us") && i + 1 < (size_t) argc)
+            bench.latency_us = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--bandwidth") && i + 1 < (size_t) argc)
+            bench.bandwidth = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--iterations") && i + 1 < (size_t) argc)
+            bench.iterations = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--objects") && i + 1 < (size_t) argc)
+            bench.num_objects = (size_t) strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--quick"))
+            bench.quick = 1;
+        else if (!strcmp(argv[i], "--loopback"))
+            bench.loopback = 1;
+        else if (!strcmp(argv[i], "--output") && i + 1 < (size_t) argc)
+            bench.output = argv[++i];
+        else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+            usage(argv[0]);
+            return 0;
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench.loopback && bench.endpoint) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (bench.iterations < 1)
+        bench.iterations = 1;
+    if (!bench.num_objects)
+        bench.num_objects = bench.quick ? BENCH_OBJECTS_DEFAULT / 4 : BENCH_OBJECTS_DEFAULT;
+
+    sizes = bench.quick ? quick_sizes : default_sizes;
+    nsizes = bench.quick ? sizeof(quick_sizes) / sizeof(quick_sizes[0]) : sizeof(default_sizes) / sizeof(default_sizes[0]);
+
+    /* Start the mock server and point the plugin at it, or have the plugin
+     * hand its requests straight to the mock server's request handler
+     */
+    if (bench.loopback) {
+        if (NULL == (server = rv_mock_hsds_create(NULL))) {
+            fprintf(stderr, "couldn't create mock HSDS server\n");
+            goto done;
+        }
+
+        if (RVset_loopback_handler(bench_loopback_handler, server) < 0)
+            goto done;
+
+        bench.endpoint = "loopback";
+    }
+    else if (!bench.endpoint) {
+        memset(&config, 0, sizeof(config));
+        config.latency_us = bench.latency_us;
+        config.bandwidth_bytes_per_sec = bench.bandwidth;
+
+        if (NULL == (server = rv_mock_hsds_create(&config)) || rv_mock_hsds_start(server, 0, &port) < 0) {
+            fprintf(stderr, "couldn't start mock HSDS server\n");
+            goto done;
+        }
+
+        snprintf(endpoint, sizeof(endpoint), "http://127.0.0.1:%u", (unsigned) port);
+        bench.endpoint = endpoint;
+    }
+
+    if (!bench.loopback)
+        setenv("HSDS_ENDPOINT", bench.endpoint, 1);
+
+    if (bench.output && NULL == (bench.json = fopen(bench.output, "w"))) {
+        fprintf(stderr, "couldn't open output file '%s'\n", bench.output);
+        goto done;
+    }
+
+    if (bench.json)
+        fprintf(bench.json, "{\n  \"config\": {\"endpoint\": \"%s\", \"mock_server\": %s, \"loopback\": %s, \"latency_us\": %llu, "
+                            "\"bandwidth_bytes_per_sec\": %llu, \"iterations\": %d, \"objects\": %zu},\n"
+                            "  \"results\": [",
+                bench.endpoint, server ? "true" : "false", bench.loopback ? "true" : "false", (unsigned long long) bench.latency_us,
+                (unsigned long long) bench.bandwidth, bench.iterations, bench.num_objects);
+
+    if (RVinit() < 0)
+        goto done;
+    rv_initialized = 1;
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        goto done;
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        goto done;
+    if ((file_id = H5Fcreate(bench.filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        fprintf(stderr, "couldn't create file '%s' on %s\n", bench.filename, bench.endpoint);
+        goto done;
+    }
+
+    printf("REST VOL benchmarks against %s%s\n\n", bench.endpoint, server ? " (mock server)" : "");
+    printf("%-18s %-14s %10s %8s %10s %12s %12s %10s\n",
+           "benchmark", "variant", "size", "ops", "seconds", "MiB/s", "ops/s", "requests");
+
+    for (i = 0; i < nsizes; i++)
+        if (bench_dataset_io(file_id, sizes[i]) < 0) {
+            fprintf(stderr, "dataset I/O benchmark failed for size %zu\n", sizes[i]);
+            goto done;
+        }
+
+    if (bench_multi_read(file_id, sizes[nsizes / 2]) < 0) {
+        fprintf(stderr, "batched read benchmark failed\n");
+        goto done;
+    }
+
+    if (bench_metadata(file_id) < 0) {
+        fprintf(stderr, "metadata benchmark failed\n");
+        goto done;
+    }
+
+    ret_value = bench.num_failures ? 1 : 0;
+
+done:
+    if (bench.json) {
+        fprintf(bench.json, "\n  ]");
+        if (server && rv_mock_hsds_get_stats(server, &server_stats) == 0)
+            fprintf(bench.json, ",\n  \"server\": {\"requests\": %llu, \"connections\": %llu, "
+                                "\"bytes_received\": %llu, \"bytes_sent\": %llu}",
+                    (unsigned long long) server_stats.num_requests, (unsigned long long) server_stats.num_connections,
+                    (unsigned long long) server_stats.bytes_received, (unsigned long long) server_stats.bytes_sent);
+        fprintf(bench.json, "\n}\n");
+        fclose(bench.json);
+    }
+
+    H5E_BEGIN_TRY {
+        H5Fclose(file_id);
+        H5Pclose(fapl_id);
+    } H5E_END_TRY;
+
+    if (rv_initialized)
+        RVterm();
+
+    if (bench.loopback)
+        RVset_loopback_handler(NULL, NULL);
+    rv_mock_hsds_free_response(&bench.loopback_response);
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return ret_value;
+}
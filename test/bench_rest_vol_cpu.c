@@ -0,0 +1,1332 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5. The full HDF5 copyright notice, including      *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic document set and is     *
+ * linked from the top-level documents page.  It can also be found at        *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have access   *
+ * to either file, you may request a copy from help@hdfgroup.org.            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: Microbenchmarks for the CPU-bound internal routines of the REST
+ *          VOL plugin, which need no server to run: conversion of dataspace
+ *          selections and datatypes to and from their JSON representations,
+ *          base64 and URL encoding, building link and attribute tables from
+ *          captured server responses, scanning for the end of a JSON section
+ *          scattering read data into a user buffer, reading responses
+ *          into a response buffer and getting the headers for requests.
+ *
+ *          Since these routines are private to the plugin, its source file
+ *          is compiled directly into this program with memory tracking
+ *          enabled, which also allows the number of allocations made by
+ *          each routine to be counted. Each operation is repeated until
+ *          both a minimum number of repetitions and a minimum amount of time
+ *          have been reached, and the average time and number of
+ *          allocations per operation is reported. Allocations made by cURL
+ *          and YAJL on the plugin's behalf are not included in the counts,
+ *          though the blocks that cURL holds are counted separately so that
+ *          lists of headers can be checked for leaks.
+ *
+ *          The routines' results on the fixtures are checked as well, so
+ *          that a short run also serves as a test of the routines.
+ */
+
+/* Always track memory usage so that allocations can be counted */
+#ifndef RV_TRACK_MEM_USAGE
+#define RV_TRACK_MEM_USAGE
+#endif
+
+#include "rest_vol.c"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#define BENCH_MIN_TIME_DEFAULT   0.5
+#define BENCH_ITERATIONS_DEFAULT 3
+
+#define BENCH_COMPOUND_MEMBERS   2048
+#define BENCH_NUM_LINKS          100000
+#define BENCH_NUM_ATTRIBUTES     10000
+#define BENCH_NUM_POINTS         (1024 * 1024)
+#define BENCH_BASE64_SIZE        (16 * 1024 * 1024)
+#define BENCH_PATH_COMPONENTS    32
+#define BENCH_RESPONSE_SIZE      (4 * 1024 * 1024)
+#define BENCH_RESPONSE_CHUNK     (16 * 1024)
+#define BENCH_DOMAIN             "/home/bench_user/bench_rest_vol_cpu.h5"
+
+#define BENCH_QUICK_DIVISOR      64
+
+/* What the fixtures are expected to be converted to, checked before each
+ * routine is timed so that a benchmark can't pass by doing the wrong work
+ */
+#define BENCH_HYPERSLAB_PARAM    "[1:59:2,2:124:2,3:247:2,4:504:2]"
+#define BENCH_BASE64_PLAIN       "foobar"
+#define BENCH_BASE64_ENCODED     "Zm9vYmFy"
+#define BENCH_URL_PLAIN          "/group 01/a&b=c/{x}"
+#define BENCH_URL_ENCODED        "/group%2001/a%26b%3Dc/%7Bx%7D"
+
+static struct {
+    const char *filter;
+    const char *output;
+    double      min_time;
+    size_t      iterations;
+    int         quick;
+    FILE       *json;
+    int         num_results;
+    int         num_failures;
+} bench;
+
+/* A growable string used to build up the fixtures */
+typedef struct {
+    char   *buf;
+    size_t  len;
+    size_t  size;
+} bench_str_t;
+
+typedef int (*bench_op_t)(void *op_data);
+
+/* Number of blocks allocated by cURL which haven't been freed yet */
+static size_t bench_curl_blocks;
+
+static double
+bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+}
+
+static size_t
+bench_scale(size_t n)
+{
+    return bench.quick ? (n / BENCH_QUICK_DIVISOR ? n / BENCH_QUICK_DIVISOR : 1) : n;
+}
+
+/*
+ * Memory callbacks for cURL which count the blocks it holds
+ */
+
+static void *
+bench_curl_malloc(size_t size)
+{
+    void *mem = malloc(size);
+
+    if (mem)
+        bench_curl_blocks++;
+
+    return mem;
+}
+
+static void
+bench_curl_free(void *mem)
+{
+    if (mem)
+        bench_curl_blocks--;
+
+    free(mem);
+}
+
+static void *
+bench_curl_realloc(void *mem, size_t size)
+{
+    void *new_mem = realloc(mem, size);
+
+    if (new_mem && !mem)
+        bench_curl_blocks++;
+
+    return new_mem;
+}
+
+static char *
+bench_curl_strdup(const char *str)
+{
+    char *new_str = strdup(str);
+
+    if (new_str)
+        bench_curl_blocks++;
+
+    return new_str;
+}
+
+static void *
+bench_curl_calloc(size_t nmemb, size_t size)
+{
+    void *mem = calloc(nmemb, size);
+
+    if (mem)
+        bench_curl_blocks++;
+
+    return mem;
+}
+
+static int
+bench_str_append(bench_str_t *str, const char *fmt, ...)
+{
+    va_list ap;
+    int     len;
+
+    for (;;) {
+        va_start(ap, fmt);
+        len = vsnprintf(str->buf + str->len, str->size - str->len, fmt, ap);
+        va_end(ap);
+
+        if (len < 0)
+            return -1;
+
+        if (str->len + (size_t) len < str->size)
+            break;
+
+        {
+            size_t  new_size = str->size ? str->size : 4096;
+            char   *tmp;
+
+            while (new_size <= str->len + (size_t) len)
+                new_size *= 2;
+
+            if (NULL == (tmp = realloc(str->buf, new_size)))
+                return -1;
+
+            str->buf = tmp;
+            str->size = new_size;
+        }
+    }
+
+    str->len += (size_t) len;
+
+    return 0;
+}
+
+/*
+ * Runs an operation in batches of doubling size until it has been
+ * repeated at least the minimum number of times for at least the
+ * minimum amount of time, then reports the averages per operation
+ */
+static int
+bench_run(const char *benchmark, const char *variant, size_t size, bench_op_t op, void *op_data)
+{
+    size_t allocs_before, bytes_before;
+    size_t ops = 0, batch = 1, i;
+    double start, elapsed;
+    double ns_per_op, allocs_per_op, bytes_per_op;
+
+    if (bench.filter && !strstr(benchmark, bench.filter))
+        return 0;
+
+    /* Run once first, both to check that the operation works on the given
+     * fixture and so that one-time setup costs aren't measured
+     */
+    if (op(op_data) < 0) {
+        fprintf(stderr, "%s/%s failed\n", benchmark, variant);
+        bench.num_failures++;
+        return -1;
+    }
+
+    allocs_before = rest_num_allocs;
+    bytes_before = rest_total_alloc_bytes;
+    start = bench_now();
+
+    for (;;) {
+        for (i = 0; i < batch; i++)
+            if (op(op_data) < 0) {
+                fprintf(stderr, "%s/%s failed\n", benchmark, variant);
+                bench.num_failures++;
+                return -1;
+            }
+
+        ops += batch;
+        elapsed = bench_now() - start;
+
+        if (ops >= bench.iterations && elapsed >= bench.min_time)
+            break;
+
+        batch *= 2;
+    }
+
+    ns_per_op = elapsed * 1e9 / (double) ops;
+    allocs_per_op = (double) (rest_num_allocs - allocs_before) / (double) ops;
+    bytes_per_op = (double) (rest_total_alloc_bytes - bytes_before) / (double) ops;
+
+    printf("%-28s %-16s %10zu %10zu %14.1f %12.2f %14.1f\n",
+           benchmark, variant, size, ops, ns_per_op, allocs_per_op, bytes_per_op);
+
+    if (bench.json)
+        fprintf(bench.json,
+                "%s\n    {\"benchmark\": \"%s\", \"variant\": \"%s\", \"size\": %zu, \"ops\": %zu, "
+                "\"seconds\": %.6f, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, \"bytes_per_op\": %.1f}",
+                bench.num_results ? "," : "", benchmark, variant, size, ops, elapsed,
+                ns_per_op, allocs_per_op, bytes_per_op);
+
+    bench.num_results++;
+
+    return 0;
+}
+
+
+/*
+ * RV_convert_dataspace_selection_to_string
+ */
+
+typedef struct {
+    hid_t   space_id;
+    hbool_t req_param;
+} bench_selection_t;
+
+static int
+bench_selection_op(void *op_data)
+{
+    bench_selection_t *sel = (bench_selection_t *) op_data;
+    size_t             len = 0;
+    char              *str = NULL;
+
+    if (RV_convert_dataspace_selection_to_string(sel->space_id, &str, &len, sel->req_param) < 0)
+        return -1;
+
+    RV_free(str);
+
+    return 0;
+}
+
+/* Selects npoints elements scattered throughout an n x n dataspace, in an
+ * order that jumps around the dataspace as a user's point list might
+ */
+static hid_t
+bench_make_point_space(hsize_t n, size_t npoints)
+{
+    hsize_t  dims[2] = { n, n };
+    hsize_t *coords = NULL;
+    hsize_t  total = n * n;
+    hid_t    space_id = -1;
+    size_t   i;
+
+    if (NULL == (coords = malloc(2 * npoints * sizeof(*coords))))
+        goto error;
+
+    for (i = 0; i < npoints; i++) {
+        /* 2654435761 is coprime to any power-of-two number of elements */
+        hsize_t idx = ((hsize_t) i * 2654435761ULL) % total;
+
+        coords[2 * i] = idx / n;
+        coords[2 * i + 1] = idx % n;
+    }
+
+    if ((space_id = H5Screate_simple(2, dims, NULL)) < 0)
+        goto error;
+    if (H5Sselect_elements(space_id, H5S_SELECT_SET, npoints, coords) < 0)
+        goto error;
+
+    free(coords);
+
+    return space_id;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(space_id);
+    } H5E_END_TRY;
+    free(coords);
+
+    return -1;
+}
+
+static int
+bench_selections(void)
+{
+    bench_selection_t sel;
+    hsize_t           dims[4] = { 64, 128, 256, 512 };
+    hsize_t           start[4] = { 1, 2, 3, 4 };
+    hsize_t           stride[4] = { 4, 4, 8, 8 };
+    hsize_t           count[4] = { 15, 31, 31, 63 };
+    hsize_t           block[4] = { 2, 2, 4, 4 };
+    size_t            npoints = bench_scale(BENCH_NUM_POINTS);
+    int               ret_value = 0;
+
+    if ((sel.space_id = H5Screate_simple(4, dims, NULL)) < 0)
+        return -1;
+    if (H5Sselect_hyperslab(sel.space_id, H5S_SELECT_SET, start, stride, count, block) < 0)
+        ret_value = -1;
+
+    if (!ret_value) {
+        size_t  len = 0;
+        char   *str = NULL;
+
+        if (RV_convert_dataspace_selection_to_string(sel.space_id, &str, &len, TRUE) < 0)
+            ret_value = -1;
+        else if (strcmp(str, BENCH_HYPERSLAB_PARAM)) {
+            fprintf(stderr, "hyperslab selection was converted to '%s' instead of '%s'\n", str, BENCH_HYPERSLAB_PARAM);
+            ret_value = -1;
+        }
+
+        RV_free(str);
+    }
+
+    if (!ret_value) {
+        sel.req_param = TRUE;
+        bench_run("selection_to_string", "hyperslab_param", 4, bench_selection_op, &sel);
+
+        sel.req_param = FALSE;
+        bench_run("selection_to_string", "hyperslab_json", 4, bench_selection_op, &sel);
+    }
+
+    H5Sclose(sel.space_id);
+
+    if ((sel.space_id = bench_make_point_space(2048, npoints)) < 0)
+        return -1;
+
+    sel.req_param = FALSE;
+    bench_run("selection_to_string", "points_json", npoints, bench_selection_op, &sel);
+
+    H5Sclose(sel.space_id);
+
+    return ret_value;
+}
+
+
+/*
+ * RV_convert_datatype_to_JSON / RV_convert_JSON_to_datatype
+ */
+
+typedef struct {
+    hid_t  type_id;
+    char  *json;
+} bench_datatype_t;
+
+static int
+bench_datatype_to_json_op(void *op_data)
+{
+    bench_datatype_t *dt = (bench_datatype_t *) op_data;
+    size_t            len = 0;
+    char             *body = NULL;
+
+    if (RV_convert_datatype_to_JSON(dt->type_id, &body, &len, FALSE) < 0)
+        return -1;
+
+    RV_free(body);
+
+    return 0;
+}
+
+static int
+bench_json_to_datatype_op(void *op_data)
+{
+    bench_datatype_t *dt = (bench_datatype_t *) op_data;
+    hid_t             type_id;
+
+    if ((type_id = RV_convert_JSON_to_datatype(dt->json)) < 0)
+        return -1;
+
+    return H5Tclose(type_id) < 0 ? -1 : 0;
+}
+
+/* Creates a compound type with nmembers members that cycle through each of
+ * the kinds of datatype the plugin can convert, including nested ones
+ */
+static hid_t
+bench_make_compound_type(size_t nmembers)
+{
+    hsize_t array_dims[2] = { 4, 3 };
+    hid_t   member_types[6] = { -1, -1, -1, -1, -1, -1 };
+    hid_t   nested_type = -1;
+    hid_t   type_id = -1;
+    size_t  offset = 0, i;
+    char    name[32];
+    int     val;
+
+    if ((member_types[0] = H5Tcopy(H5T_STD_I32LE)) < 0)
+        goto error;
+    if ((member_types[1] = H5Tcopy(H5T_IEEE_F64LE)) < 0)
+        goto error;
+    if ((member_types[2] = H5Tcopy(H5T_C_S1)) < 0 || H5Tset_size(member_types[2], 24) < 0)
+        goto error;
+    if ((member_types[3] = H5Tarray_create2(H5T_IEEE_F32LE, 2, array_dims)) < 0)
+        goto error;
+
+    if ((nested_type = H5Tcreate(H5T_COMPOUND, 2 + 8 + 1)) < 0)
+        goto error;
+    if (H5Tinsert(nested_type, "a", 0, H5T_STD_I16LE) < 0 || H5Tinsert(nested_type, "b", 2, H5T_STD_I64LE) < 0
+            || H5Tinsert(nested_type, "c", 10, H5T_STD_U8LE) < 0)
+        goto error;
+    member_types[4] = nested_type;
+    nested_type = -1;
+
+    if ((member_types[5] = H5Tenum_create(H5T_STD_I32LE)) < 0)
+        goto error;
+    for (val = 0; val < 4; val++) {
+        snprintf(name, sizeof(name), "VALUE_%d", val);
+        if (H5Tenum_insert(member_types[5], name, &val) < 0)
+            goto error;
+    }
+
+    for (i = 0; i < nmembers; i++)
+        offset += H5Tget_size(member_types[i % 6]);
+
+    if ((type_id = H5Tcreate(H5T_COMPOUND, offset)) < 0)
+        goto error;
+
+    for (i = 0, offset = 0; i < nmembers; i++) {
+        snprintf(name, sizeof(name), "member_%05zu", i);
+        if (H5Tinsert(type_id, name, offset, member_types[i % 6]) < 0)
+            goto error;
+        offset += H5Tget_size(member_types[i % 6]);
+    }
+
+    for (i = 0; i < 6; i++)
+        H5Tclose(member_types[i]);
+
+    return type_id;
+
+error:
+    H5E_BEGIN_TRY {
+        for (i = 0; i < 6; i++)
+            H5Tclose(member_types[i]);
+        H5Tclose(nested_type);
+        H5Tclose(type_id);
+    } H5E_END_TRY;
+
+    return -1;
+}
+
+static int
+bench_datatypes(void)
+{
+    bench_datatype_t dt;
+    size_t           nmembers = bench_scale(BENCH_COMPOUND_MEMBERS);
+    size_t           len = 0;
+    char            *body = NULL;
+    hid_t            check_type_id;
+    int              ret_value = -1;
+
+    dt.type_id = -1;
+    dt.json = NULL;
+
+    if ((dt.type_id = H5Tcopy(H5T_STD_I32LE)) < 0)
+        goto done;
+
+    bench_run("datatype_to_json", "integer", 1, bench_datatype_to_json_op, &dt);
+
+    H5Tclose(dt.type_id);
+
+    if ((dt.type_id = bench_make_compound_type(nmembers)) < 0)
+        goto done;
+
+    bench_run("datatype_to_json", "compound", nmembers, bench_datatype_to_json_op, &dt);
+
+    /* Capture the plugin's own JSON for the type to convert back, the same
+     * form in which it comes back from the server
+     */
+    if (RV_convert_datatype_to_JSON(dt.type_id, &body, &len, FALSE) < 0)
+        goto done;
+    if (NULL == (dt.json = malloc(len + 3)))
+        goto done;
+    snprintf(dt.json, len + 3, "{%s}", body);
+
+    if ((check_type_id = RV_convert_JSON_to_datatype(dt.json)) < 0)
+        goto done;
+    if (H5Tget_nmembers(check_type_id) != (int) nmembers) {
+        fprintf(stderr, "compound type didn't survive conversion to JSON and back\n");
+        H5Tclose(check_type_id);
+        goto done;
+    }
+    H5Tclose(check_type_id);
+
+    bench_run("json_to_datatype", "compound", nmembers, bench_json_to_datatype_op, &dt);
+
+    ret_value = 0;
+
+done:
+    H5E_BEGIN_TRY {
+        H5Tclose(dt.type_id);
+    } H5E_END_TRY;
+    RV_free(body);
+    free(dt.json);
+
+    return ret_value;
+}
+
+
+/*
+ * RV_base64_encode
+ */
+
+typedef struct {
+    unsigned char *buf;
+    size_t         size;
+} bench_base64_t;
+
+static int
+bench_base64_op(void *op_data)
+{
+    bench_base64_t *b64 = (bench_base64_t *) op_data;
+    size_t          out_size = 0;
+    char           *out = NULL;
+
+    if (RV_base64_encode(b64->buf, b64->size, &out, &out_size) < 0)
+        return -1;
+
+    RV_free(out);
+
+    return 0;
+}
+
+static int
+bench_base64(void)
+{
+    bench_base64_t b64;
+    size_t         size = bench_scale(BENCH_BASE64_SIZE);
+    size_t         out_size = 0;
+    size_t         i;
+    char          *out = NULL;
+
+    if (RV_base64_encode(BENCH_BASE64_PLAIN, strlen(BENCH_BASE64_PLAIN), &out, &out_size) < 0)
+        return -1;
+    if (out_size != strlen(BENCH_BASE64_ENCODED) || strncmp(out, BENCH_BASE64_ENCODED, out_size)) {
+        fprintf(stderr, "'%s' was base64-encoded to '%.*s' instead of '%s'\n", BENCH_BASE64_PLAIN, (int) out_size, out,
+                BENCH_BASE64_ENCODED);
+        RV_free(out);
+        return -1;
+    }
+    RV_free(out);
+
+    if (NULL == (b64.buf = malloc(size)))
+        return -1;
+
+    for (i = 0; i < size; i++)
+        b64.buf[i] = (unsigned char) (i * 31 + (i >> 8));
+
+    b64.size = 64;
+    bench_run("base64_encode", "small", b64.size, bench_base64_op, &b64);
+
+    b64.size = size;
+    bench_run("base64_encode", "large", b64.size, bench_base64_op, &b64);
+
+    free(b64.buf);
+
+    return 0;
+}
+
+
+/*
+ * RV_url_encode_path
+ */
+
+static int
+bench_url_encode_op(void *op_data)
+{
+    char *encoded;
+
+    if (NULL == (encoded = RV_url_encode_path((const char *) op_data)))
+        return -1;
+
+    RV_free(encoded);
+
+    return 0;
+}
+
+static int
+bench_url_encode(void)
+{
+    bench_str_t plain = { NULL, 0, 0 };
+    bench_str_t escaped = { NULL, 0, 0 };
+    size_t      i;
+    char       *encoded;
+    int         ret_value = -1;
+
+    if (NULL == (encoded = RV_url_encode_path(BENCH_URL_PLAIN)))
+        goto done;
+    if (strcmp(encoded, BENCH_URL_ENCODED)) {
+        fprintf(stderr, "'%s' was URL-encoded to '%s' instead of '%s'\n", BENCH_URL_PLAIN, encoded, BENCH_URL_ENCODED);
+        RV_free(encoded);
+        goto done;
+    }
+    RV_free(encoded);
+
+    for (i = 0; i < BENCH_PATH_COMPONENTS; i++) {
+        if (bench_str_append(&plain, "/group_%02zu", i) < 0)
+            goto done;
+        if (bench_str_append(&escaped, "/group %02zu {%s}", i, i % 2 ? "\xc3\xa9t\xc3\xa9" : "a&b=c") < 0)
+            goto done;
+    }
+
+    bench_run("url_encode_path", "plain", BENCH_PATH_COMPONENTS, bench_url_encode_op, plain.buf);
+    bench_run("url_encode_path", "escaped", BENCH_PATH_COMPONENTS, bench_url_encode_op, escaped.buf);
+
+    ret_value = 0;
+
+done:
+    free(plain.buf);
+    free(escaped.buf);
+
+    return ret_value;
+}
+
+
+/*
+ * RV_build_link_table / RV_build_attr_table / FIND_JSON_SECTION_END
+ */
+
+typedef struct {
+    const char *response;
+    char       *scratch;
+    size_t      len;
+    size_t      num_entries;
+} bench_table_t;
+
+/* Both table builders modify the response they are given, so each
+ * operation works on a fresh copy of it. The copy is cheap next to the
+ * parsing, and is the same copy that the plugin makes for H5Lvisit.
+ */
+static int
+bench_link_table_op(void *op_data)
+{
+    bench_table_t    *tbl = (bench_table_t *) op_data;
+    link_table_entry *table = NULL;
+    size_t            num_entries = 0;
+
+    memcpy(tbl->scratch, tbl->response, tbl->len + 1);
+
+    if (RV_build_link_table(tbl->scratch, FALSE, cmp_links_by_name_inc, &table, &num_entries, NULL) < 0)
+        return -1;
+
+    if (table)
+        RV_free_link_table(table, num_entries);
+
+    return num_entries == tbl->num_entries ? 0 : -1;
+}
+
+static int
+bench_attr_table_op(void *op_data)
+{
+    bench_table_t    *tbl = (bench_table_t *) op_data;
+    attr_table_entry *table = NULL;
+    size_t            num_entries = 0;
+
+    memcpy(tbl->scratch, tbl->response, tbl->len + 1);
+
+    if (RV_build_attr_table(tbl->scratch, TRUE, cmp_attributes_by_creation_order, &table, &num_entries) < 0)
+        return -1;
+
+    RV_free(table);
+
+    return num_entries == tbl->num_entries ? 0 : -1;
+}
+
+static herr_t
+bench_find_section_end(char *section_start, char **section_end_out)
+{
+    char   *section_end = NULL;
+    herr_t  ret_value = SUCCEED;
+
+    FIND_JSON_SECTION_END(section_start, section_end, H5E_OBJECT, FAIL);
+
+    *section_end_out = section_end;
+
+done:
+    return ret_value;
+}
+
+static int
+bench_section_end_op(void *op_data)
+{
+    bench_table_t *tbl = (bench_table_t *) op_data;
+    char          *section_end;
+
+    if (bench_find_section_end((char *) tbl->response, &section_end) < 0)
+        return -1;
+
+    return (size_t) (section_end - tbl->response) == tbl->len ? 0 : -1;
+}
+
+/* Builds a response in the form of the server's reply to a GET of all the
+ * links in a group. Every tenth link is a soft link, and some of the link
+ * names contain characters that have to be escaped in JSON.
+ */
+static int
+bench_make_links_response(bench_str_t *str, size_t num_links)
+{
+    size_t i;
+
+    if (bench_str_append(str, "{\"links\": [") < 0)
+        return -1;
+
+    for (i = 0; i < num_links; i++) {
+        char name[64];
+
+        if (i % 16 == 7)
+            snprintf(name, sizeof(name), "link_%06zu {\\\"quoted\\\\\\\"}", i);
+        else
+            snprintf(name, sizeof(name), "link_%06zu", i);
+
+        if (i % 10 == 9) {
+            if (bench_str_append(str,
+                    "%s{\"class\": \"H5L_TYPE_SOFT\", \"title\": \"%s\", \"h5path\": \"/targets/target_%06zu\", "
+                    "\"created\": %.3f, \"href\": \"http://hsds.test/groups/g-00000000-4d4f-434b-4853-000000000001/links/link_%06zu\"}",
+                    i ? ", " : "", name, i, 1543622400.0 + (double) i / 1000.0, i) < 0)
+                return -1;
+        }
+        else {
+            if (bench_str_append(str,
+                    "%s{\"class\": \"H5L_TYPE_HARD\", \"title\": \"%s\", \"collection\": \"%s\", "
+                    "\"id\": \"%c-00000000-4d4f-434b-4853-%012zx\", \"created\": %.3f, "
+                    "\"href\": \"http://hsds.test/groups/g-00000000-4d4f-434b-4853-000000000001/links/link_%06zu\", "
+                    "\"target\": \"http://hsds.test/%s/%c-00000000-4d4f-434b-4853-%012zx\"}",
+                    i ? ", " : "", name, i % 2 ? "datasets" : "groups", i % 2 ? 'd' : 'g', i,
+                    1543622400.0 + (double) i / 1000.0, i, i % 2 ? "datasets" : "groups", i % 2 ? 'd' : 'g', i) < 0)
+                return -1;
+        }
+    }
+
+    return bench_str_append(str, "], \"hrefs\": [{\"href\": \"http://hsds.test/groups/g-00000000-4d4f-434b-4853-000000000001/links\", "
+                                 "\"rel\": \"self\"}, {\"href\": \"http://hsds.test/\", \"rel\": \"home\"}]}");
+}
+
+/* Builds a response in the form of the server's reply to a GET of all the
+ * attributes attached to an object, including their types and shapes
+ */
+static int
+bench_make_attrs_response(bench_str_t *str, size_t num_attrs)
+{
+    size_t i;
+
+    if (bench_str_append(str, "{\"attributes\": [") < 0)
+        return -1;
+
+    for (i = 0; i < num_attrs; i++) {
+        if (bench_str_append(str,
+                "%s{\"name\": \"attr_%06zu\", \"created\": %.3f, "
+                "\"type\": {\"class\": \"H5T_COMPOUND\", \"fields\": [{\"name\": \"x\", \"type\": {\"class\": \"H5T_FLOAT\", \"base\": \"H5T_IEEE_F64LE\"}}, "
+                "{\"name\": \"label\", \"type\": {\"class\": \"H5T_STRING\", \"charSet\": \"H5T_CSET_ASCII\", \"strPad\": \"H5T_STR_NULLTERM\", \"length\": 16}}]}, "
+                "\"shape\": {\"class\": \"H5S_SIMPLE\", \"dims\": [2]}, "
+                "\"value\": [[%zu.5, \"{label}\"], [%zu.25, \"\\\"q\\\"\"]], "
+                "\"href\": \"http://hsds.test/groups/g-00000000-4d4f-434b-4853-000000000001/attributes/attr_%06zu\"}",
+                i ? ", " : "", i, 1543622400.0 + (double) (num_attrs - i) / 1000.0, i, i, i) < 0)
+            return -1;
+    }
+
+    return bench_str_append(str, "], \"hrefs\": [{\"href\": \"http://hsds.test/groups/g-00000000-4d4f-434b-4853-000000000001/attributes\", "
+                                 "\"rel\": \"self\"}]}");
+}
+
+static int
+bench_tables(void)
+{
+    bench_table_t tbl;
+    bench_str_t   links = { NULL, 0, 0 };
+    bench_str_t   attrs = { NULL, 0, 0 };
+    size_t        num_links = bench_scale(BENCH_NUM_LINKS);
+    size_t        num_attrs = bench_scale(BENCH_NUM_ATTRIBUTES);
+    int           ret_value = -1;
+
+    tbl.scratch = NULL;
+
+    if (bench_make_links_response(&links, num_links) < 0)
+        goto done;
+    if (bench_make_attrs_response(&attrs, num_attrs) < 0)
+        goto done;
+
+    if (NULL == (tbl.scratch = malloc((links.len > attrs.len ? links.len : attrs.len) + 1)))
+        goto done;
+
+    tbl.response = links.buf;
+    tbl.len = links.len;
+    tbl.num_entries = num_links;
+    bench_run("build_link_table", "links", num_links, bench_link_table_op, &tbl);
+    bench_run("find_json_section_end", "links", links.len, bench_section_end_op, &tbl);
+
+    tbl.response = attrs.buf;
+    tbl.len = attrs.len;
+    tbl.num_entries = num_attrs;
+    bench_run("build_attr_table", "attributes", num_attrs, bench_attr_table_op, &tbl);
+    bench_run("find_json_section_end", "attributes", attrs.len, bench_section_end_op, &tbl);
+
+    ret_value = 0;
+
+done:
+    free(links.buf);
+    free(attrs.buf);
+    free(tbl.scratch);
+
+    return ret_value;
+}
+
+
+/*
+ * dataset_read_scatter_op, as driven by H5Dscatter() during a read
+ */
+
+typedef struct {
+    read_scatter_info info;
+    hid_t             mem_space_id;
+    int              *user_buf;
+} bench_scatter_t;
+
+static int
+bench_scatter_op(void *op_data)
+{
+    bench_scatter_t *sc = (bench_scatter_t *) op_data;
+
+    return H5Dscatter(dataset_read_scatter_op, &sc->info, H5T_NATIVE_INT, sc->mem_space_id, sc->user_buf) < 0 ? -1 : 0;
+}
+
+static int
+bench_scatter(void)
+{
+    bench_scatter_t sc;
+    hsize_t         n = 2048;
+    hsize_t         dims[2] = { 2048, 2048 };
+    hsize_t         start[2] = { 0, 0 };
+    hsize_t         stride[2] = { 1, 2 };
+    hsize_t         count[2] = { 0, 0 };
+    size_t          npoints = bench_scale(BENCH_NUM_POINTS);
+    size_t          i;
+    int            *read_buf = NULL;
+    int             ret_value = -1;
+
+    sc.mem_space_id = -1;
+    sc.user_buf = NULL;
+
+    if (NULL == (read_buf = malloc(npoints * sizeof(*read_buf))))
+        goto done;
+    if (NULL == (sc.user_buf = malloc(n * n * sizeof(*sc.user_buf))))
+        goto done;
+
+    for (i = 0; i < npoints; i++)
+        read_buf[i] = (int) i;
+
+    sc.info.buffer = read_buf;
+    sc.info.buffer_size = npoints * sizeof(*read_buf);
+
+    /* Every other column of a block of rows holding the same number of
+     * elements as the point selection
+     */
+    count[1] = n / 2;
+    count[0] = npoints / count[1] ? npoints / count[1] : 1;
+
+    if ((sc.mem_space_id = H5Screate_simple(2, dims, NULL)) < 0)
+        goto done;
+    if (H5Sselect_hyperslab(sc.mem_space_id, H5S_SELECT_SET, start, stride, count, NULL) < 0)
+        goto done;
+
+    sc.info.buffer_size = (size_t) (count[0] * count[1]) * sizeof(*read_buf);
+    if (sc.info.buffer_size > npoints * sizeof(*read_buf))
+        goto done;
+
+    /* The data should be scattered into every other column */
+    if (bench_scatter_op(&sc) < 0)
+        goto done;
+    for (i = 0; i < (size_t) (count[0] * count[1]); i++)
+        if (sc.user_buf[(i / count[1]) * n + 2 * (i % count[1])] != read_buf[i]) {
+            fprintf(stderr, "read data was scattered to the wrong place in the hyperslab selection\n");
+            goto done;
+        }
+
+    bench_run("read_scatter", "hyperslab", (size_t) (count[0] * count[1]), bench_scatter_op, &sc);
+
+    H5Sclose(sc.mem_space_id);
+
+    if ((sc.mem_space_id = bench_make_point_space(n, npoints)) < 0)
+        goto done;
+
+    sc.info.buffer_size = npoints * sizeof(*read_buf);
+
+    /* The data should be scattered in the order that the points were selected */
+    if (bench_scatter_op(&sc) < 0)
+        goto done;
+    for (i = 0; i < npoints; i++)
+        if (sc.user_buf[((hsize_t) i * 2654435761ULL) % (n * n)] != read_buf[i]) {
+            fprintf(stderr, "read data was scattered to the wrong place in the point selection\n");
+            goto done;
+        }
+
+    bench_run("read_scatter", "points", npoints, bench_scatter_op, &sc);
+
+    ret_value = 0;
+
+done:
+    H5E_BEGIN_TRY {
+        H5Sclose(sc.mem_space_id);
+    } H5E_END_TRY;
+    free(sc.user_buf);
+    free(read_buf);
+
+    return ret_value;
+}
+
+/*
+ * RV_response_header_callback / curl_write_data_callback / RV_response_buffer_reset
+ */
+
+typedef struct {
+    RV_response_buffer_t resp;
+    const char          *body;
+    size_t               size;
+    hbool_t              content_length;
+} bench_response_t;
+
+/* Feeds a response to the callbacks the way cURL would, in chunks after
+ * the headers, into a buffer readied as it would be before a request
+ */
+static int
+bench_response_op(void *op_data)
+{
+    bench_response_t *rsp = (bench_response_t *) op_data;
+    char              header[64];
+    size_t            i, chunk;
+
+    if (RV_response_buffer_reset(&rsp->resp) < 0)
+        return -1;
+
+    strcpy(header, "HTTP/1.1 200 OK\r\n");
+    if (RV_response_header_callback(header, 1, strlen(header), &rsp->resp) != strlen(header))
+        return -1;
+
+    if (rsp->content_length) {
+        snprintf(header, sizeof(header), "Content-Length: %zu\r\n", rsp->size);
+        if (RV_response_header_callback(header, 1, strlen(header), &rsp->resp) != strlen(header))
+            return -1;
+    }
+
+    for (i = 0; i < rsp->size; i += chunk) {
+        chunk = rsp->size - i < BENCH_RESPONSE_CHUNK ? rsp->size - i : BENCH_RESPONSE_CHUNK;
+
+        if (curl_write_data_callback((char *) rsp->body + i, 1, chunk, &rsp->resp) != chunk)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int
+bench_response(void)
+{
+    bench_response_t rsp;
+    size_t           allocs_before;
+    size_t           i;
+    char            *body = NULL;
+    int              ret_value = -1;
+
+    memset(&rsp, 0, sizeof(rsp));
+
+    if (NULL == (body = malloc(BENCH_RESPONSE_SIZE)))
+        goto done;
+
+    for (i = 0; i < BENCH_RESPONSE_SIZE; i++)
+        body[i] = (char) (i * 31 + (i >> 8));
+
+    if (NULL == (rsp.resp.buffer = (char *) RV_malloc(CURL_RESPONSE_BUFFER_DEFAULT_SIZE)))
+        goto done;
+    rsp.resp.buffer_size = CURL_RESPONSE_BUFFER_DEFAULT_SIZE;
+    rsp.resp.curr_buf_ptr = rsp.resp.buffer;
+    rsp.body = body;
+    rsp.size = BENCH_RESPONSE_SIZE;
+    rsp.content_length = TRUE;
+
+    /* A response with a Content-Length should be given its room all at
+     * once, and then written without the buffer being grown again
+     */
+    allocs_before = rest_num_allocs;
+
+    if (bench_response_op(&rsp) < 0)
+        goto done;
+
+    if (rest_num_allocs - allocs_before != 1 || rsp.resp.buffer_size != BENCH_RESPONSE_SIZE + 1) {
+        fprintf(stderr, "a %d byte response with a Content-Length took %zu allocations for a %zu byte buffer "
+                        "instead of one for a %d byte buffer\n",
+                BENCH_RESPONSE_SIZE, rest_num_allocs - allocs_before, rsp.resp.buffer_size, BENCH_RESPONSE_SIZE + 1);
+        goto done;
+    }
+
+    if ((size_t) (rsp.resp.curr_buf_ptr - rsp.resp.buffer) != BENCH_RESPONSE_SIZE
+            || memcmp(rsp.resp.buffer, body, BENCH_RESPONSE_SIZE)) {
+        fprintf(stderr, "the response was written to the response buffer incorrectly\n");
+        goto done;
+    }
+
+    /* The large buffer should be shrunk back before the next request, unless
+     * the next response needs the room
+     */
+    rsp.resp.size_hint = BENCH_RESPONSE_SIZE;
+    if (RV_response_buffer_reset(&rsp.resp) < 0)
+        goto done;
+    if (rsp.resp.buffer_size != BENCH_RESPONSE_SIZE + 1) {
+        fprintf(stderr, "a response buffer needed for the next response was resized to %zu bytes\n",
+                rsp.resp.buffer_size);
+        goto done;
+    }
+
+    if (RV_response_buffer_reset(&rsp.resp) < 0)
+        goto done;
+    if (rsp.resp.buffer_size != CURL_RESPONSE_BUFFER_DEFAULT_SIZE) {
+        fprintf(stderr, "a %d byte response buffer was kept at %zu bytes instead of being shrunk to %d\n",
+                BENCH_RESPONSE_SIZE + 1, rsp.resp.buffer_size, CURL_RESPONSE_BUFFER_DEFAULT_SIZE);
+        goto done;
+    }
+
+    bench_run("response_buffer", "content_length", rsp.size, bench_response_op, &rsp);
+
+    rsp.content_length = FALSE;
+    bench_run("response_buffer", "streamed", rsp.size, bench_response_op, &rsp);
+
+    ret_value = 0;
+
+done:
+    RV_free(rsp.resp.buffer);
+    free(body);
+
+    return ret_value;
+}
+
+/*
+ * RV_get_request_headers
+ */
+
+static int
+bench_request_headers_op(void *op_data)
+{
+    RV_object_t *file = (RV_object_t *) op_data;
+
+    return RV_get_request_headers(file, RV_REQUEST_HEADERS_ACCEPT_BINARY) ? 0 : -1;
+}
+
+/* Builds the list of headers from scratch each time, as every request
+ * used to
+ */
+static int
+bench_request_headers_uncached_op(void *op_data)
+{
+    RV_object_t *file = (RV_object_t *) op_data;
+
+    if (!RV_get_request_headers(file, RV_REQUEST_HEADERS_ACCEPT_BINARY))
+        return -1;
+
+    curl_slist_free_all(file->u.file.request_headers[RV_REQUEST_HEADERS_ACCEPT_BINARY]);
+    file->u.file.request_headers[RV_REQUEST_HEADERS_ACCEPT_BINARY] = NULL;
+
+    return 0;
+}
+
+/* A file object standing in for an open domain, which only needs the
+ * fields that the headers are built from and that closing it frees
+ */
+static RV_object_t *
+bench_make_domain(void)
+{
+    RV_object_t *file;
+
+    if (NULL == (file = (RV_object_t *) RV_calloc(sizeof(*file))))
+        return NULL;
+
+    file->domain = file;
+    file->obj_type = H5I_FILE;
+    file->u.file.fapl_id = -1;
+    file->u.file.fcpl_id = -1;
+
+    if (NULL == (file->u.file.filepath_name = (char *) RV_malloc(strlen(BENCH_DOMAIN) + 1))) {
+        RV_free(file);
+        return NULL;
+    }
+    strcpy(file->u.file.filepath_name, BENCH_DOMAIN);
+
+    return file;
+}
+
+static int
+bench_request_headers(void)
+{
+    struct curl_slist *headers[RV_REQUEST_HEADERS_NTYPES];
+    struct curl_slist *node;
+    RV_object_t       *file = NULL;
+    size_t             allocs_before, blocks_before, blocks_built;
+    size_t             i;
+    int                has_domain;
+    int                ret_value = -1;
+
+    blocks_before = bench_curl_blocks;
+
+    if (NULL == (file = bench_make_domain()))
+        goto done;
+
+    for (i = 0; i < RV_REQUEST_HEADERS_NTYPES; i++) {
+        if (NULL == (headers[i] = RV_get_request_headers(file, (RV_request_headers_t) i)))
+            goto done;
+
+        for (node = headers[i], has_domain = 0; node; node = node->next)
+            if (!strcmp(node->data, "X-Hdf-domain: " BENCH_DOMAIN))
+                has_domain = 1;
+
+        if (!has_domain) {
+            fprintf(stderr, "request headers of kind %zu are missing the X-Hdf-domain header\n", i);
+            goto done;
+        }
+    }
+
+    /* Getting the headers again should hand back the same lists without
+     * building anything
+     */
+    allocs_before = rest_num_allocs;
+    blocks_built = bench_curl_blocks;
+
+    for (i = 0; i < RV_REQUEST_HEADERS_NTYPES; i++)
+        if (RV_get_request_headers(file, (RV_request_headers_t) i) != headers[i]) {
+            fprintf(stderr, "request headers of kind %zu were built again instead of being reused\n", i);
+            goto done;
+        }
+
+    if (rest_num_allocs != allocs_before || bench_curl_blocks != blocks_built) {
+        fprintf(stderr, "getting request headers that were already built allocated memory\n");
+        goto done;
+    }
+
+    bench_run("request_headers", "cached", 1, bench_request_headers_op, file);
+    bench_run("request_headers", "uncached", 1, bench_request_headers_uncached_op, file);
+
+    /* Closing the file should free every list */
+    if (RV_file_close(file, H5P_DEFAULT, NULL) < 0)
+        goto done;
+    file = NULL;
+
+    if (bench_curl_blocks != blocks_before) {
+        fprintf(stderr, "%zu blocks of request headers were left allocated after the file was closed\n",
+                bench_curl_blocks - blocks_before);
+        goto done;
+    }
+
+    ret_value = 0;
+
+done:
+    if (file)
+        RV_file_close(file, H5P_DEFAULT, NULL);
+
+    return ret_value;
+}
+
+static void
+usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [options]\n", prog);
+    fprintf(stderr, "  --min-time SECONDS  minimum time to run each benchmark for (default %.1f)\n", BENCH_MIN_TIME_DEFAULT);
+    fprintf(stderr, "  --iterations N      minimum repetitions of each benchmark (default %d)\n", BENCH_ITERATIONS_DEFAULT);
+    fprintf(stderr, "  --filter NAME       only run benchmarks whose name contains NAME\n");
+    fprintf(stderr, "  --quick             much smaller fixtures and a short minimum time\n");
+    fprintf(stderr, "  --output FILE       also write the results as JSON to FILE\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    size_t i;
+    int    min_time_given = 0;
+    int    rv_initialized = 0;
+    int    curl_initialized = 0;
+    int    ret_value = 1;
+
+    bench.min_time = BENCH_MIN_TIME_DEFAULT;
+    bench.iterations = BENCH_ITERATIONS_DEFAULT;
+
+    for (i = 1; i < (size_t) argc; i++) {
+        if (!strcmp(argv[i], "--min-time") && i + 1 < (size_t) argc) {
+            bench.min_time = atof(argv[++i]);
+            min_time_given = 1;
+        }
+        else if (!strcmp(argv[i], "--iterations") && i + 1 < (size_t) argc)
+            bench.iterations = (size_t) strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < (size_t) argc)
+            bench.filter = argv[++i];
+        else if (!strcmp(argv[i], "--quick"))
+            bench.quick = 1;
+        else if (!strcmp(argv[i], "--output") && i + 1 < (size_t) argc)
+            bench.output = argv[++i];
+        else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+            usage(argv[0]);
+            return 0;
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench.iterations < 1)
+        bench.iterations = 1;
+    if (bench.quick && !min_time_given)
+        bench.min_time = BENCH_MIN_TIME_DEFAULT / 10;
+
+    if (bench.output && NULL == (bench.json = fopen(bench.output, "w"))) {
+        fprintf(stderr, "couldn't open output file '%s'\n", bench.output);
+        goto done;
+    }
+
+    if (bench.json)
+        fprintf(bench.json, "{\n  \"config\": {\"min_time\": %.3f, \"iterations\": %zu, \"quick\": %s},\n"
+                            "  \"results\": [",
+                bench.min_time, bench.iterations, bench.quick ? "true" : "false");
+
+    /* cURL's memory callbacks can only be set before it is first initialized */
+    if (CURLE_OK != curl_global_init_mem(CURL_GLOBAL_ALL, bench_curl_malloc, bench_curl_free, bench_curl_realloc,
+                                         bench_curl_strdup, bench_curl_calloc))
+        goto done;
+    curl_initialized = 1;
+
+    if (RVinit() < 0)
+        goto done;
+    rv_initialized = 1;
+
+    printf("REST VOL CPU microbenchmarks\n\n");
+    printf("%-28s %-16s %10s %10s %14s %12s %14s\n",
+           "benchmark", "variant", "size", "ops", "ns/op", "allocs/op", "bytes/op");
+
+    if (bench_selections() < 0) {
+        fprintf(stderr, "couldn't set up selection benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_datatypes() < 0) {
+        fprintf(stderr, "couldn't set up datatype benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_base64() < 0) {
+        fprintf(stderr, "couldn't set up base64 benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_url_encode() < 0) {
+        fprintf(stderr, "couldn't set up URL encoding benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_tables() < 0) {
+        fprintf(stderr, "couldn't set up link and attribute table benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_scatter() < 0) {
+        fprintf(stderr, "couldn't set up read scatter benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_response() < 0) {
+        fprintf(stderr, "couldn't set up response buffer benchmarks\n");
+        bench.num_failures++;
+    }
+    if (bench_request_headers() < 0) {
+        fprintf(stderr, "couldn't set up request header benchmarks\n");
+        bench.num_failures++;
+    }
+
+    ret_value = bench.num_failures ? 1 : 0;
+
+done:
+    if (bench.json) {
+        fprintf(bench.json, "\n  ]\n}\n");
+        fclose(bench.json);
+    }
+
+    /* With memory tracking enabled, this also reports anything that the
+     * benchmarked routines leaked
+     */
+    if (rv_initialized && RVterm() < 0)
+        ret_value = 1;
+    if (curl_initialized)
+        curl_global_cleanup();
+
+    return ret_value;
+}
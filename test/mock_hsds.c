@@ -0,0 +1,119 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5. The full HDF5 copyright notice, including      *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic document set and is     *
+ * linked from the top-level documents page.  It can also be found at        *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have access   *
+ * to either file, you may request a copy from help@hdfgroup.org.            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: Runs the in-memory mock HSDS server as a standalone process, so
+ *          that the REST VOL test suite or any other client can be pointed
+ *          at it through HSDS_ENDPOINT.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include "rest_vol_mock_hsds.h"
+
+static void
+usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-p port] [-l latency_us] [-b bandwidth_bytes_per_sec] [-z] [-v]\n", prog);
+    fprintf(stderr, "  -p port        TCP port to listen on (default 5101, 0 picks a free port)\n");
+    fprintf(stderr, "  -l latency_us  delay added to every request, in microseconds\n");
+    fprintf(stderr, "  -b bandwidth   transfer rate limit in bytes per second; a K, M or G\n");
+    fprintf(stderr, "                 suffix multiplies by 2^10, 2^20 or 2^30\n");
+    fprintf(stderr, "  -z             compress dataset values for clients which accept it\n");
+    fprintf(stderr, "  -v             log every request to stderr\n");
+}
+
+static unsigned long long
+parse_size(const char *str)
+{
+    char               *end;
+    unsigned long long  val = strtoull(str, &end, 10);
+
+    switch (*end) {
+        case 'k': case 'K': val <<= 10; break;
+        case 'm': case 'M': val <<= 20; break;
+        case 'g': case 'G': val <<= 30; break;
+        default: break;
+    }
+
+    return val;
+}
+
+int
+main(int argc, char **argv)
+{
+    rv_mock_hsds_config_t  config;
+    rv_mock_hsds_stats_t   stats;
+    rv_mock_hsds_t        *server;
+    unsigned short         port = 5101;
+    sigset_t               sigs;
+    int                    sig, i;
+
+    memset(&config, 0, sizeof(config));
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-p") && i + 1 < argc)
+            port = (unsigned short) atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc)
+            config.latency_us = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+            config.bandwidth_bytes_per_sec = parse_size(argv[++i]);
+        else if (!strcmp(argv[i], "-z"))
+            config.compress_values = 1;
+        else if (!strcmp(argv[i], "-v"))
+            config.verbose = 1;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    /* Block the termination signals in every thread so that they can be
+     * waited for here
+     */
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sigs, NULL);
+
+    if (NULL == (server = rv_mock_hsds_create(&config))) {
+        fprintf(stderr, "couldn't create mock HSDS server\n");
+        return 1;
+    }
+
+    if (rv_mock_hsds_start(server, port, &port) < 0) {
+        fprintf(stderr, "couldn't start mock HSDS server on port %u\n", (unsigned) port);
+        rv_mock_hsds_destroy(server);
+        return 1;
+    }
+
+    printf("mock HSDS server listening on http://127.0.0.1:%u\n", (unsigned) port);
+    fflush(stdout);
+
+    sigwait(&sigs, &sig);
+
+    rv_mock_hsds_get_stats(server, &stats);
+    printf("handled %llu requests on %llu connections (%llu bytes in, %llu bytes out)\n",
+           (unsigned long long) stats.num_requests, (unsigned long long) stats.num_connections,
+           (unsigned long long) stats.bytes_received, (unsigned long long) stats.bytes_sent);
+
+    rv_mock_hsds_stop(server);
+    rv_mock_hsds_destroy(server);
+
+    return 0;
+}
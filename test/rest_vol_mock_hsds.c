@@ -0,0 +1,3090 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5. The full HDF5 copyright notice, including      *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic document set and is     *
+ * linked from the top-level documents page.  It can also be found at        *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have access   *
+ * to either file, you may request a copy from help@hdfgroup.org.            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: An in-memory stand-in for an HSDS server. See rest_vol_mock_hsds.h.
+ *
+ *          The server keeps every domain and object in memory; nothing is
+ *          persisted. All requests are serialized through a single lock
+ *          around the object store, while the emulated latency and
+ *          bandwidth delays are applied outside of that lock so that
+ *          concurrent connections overlap the way they would against a
+ *          real remote server.
+ *
+ *          Dataset values can be sent compressed in the same content
+ *          encodings that the REST VOL uses: "deflate", optionally after
+ *          "x-shuffle", which byte-shuffles the data by the size of the
+ *          dataset's elements.
+ *
+ *          Variable-length datatypes and dataset queries are not supported
+ *          and are answered with "501 Not Implemented".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include <yajl/yajl_tree.h>
+
+#include "rest_vol_config.h"
+#include "rest_vol_mock_hsds.h"
+
+#ifdef RV_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#define MOCK_ID_LENGTH            64
+#define MOCK_MAX_DIMS             32
+#define MOCK_MAX_SEGMENTS         8
+#define MOCK_MAX_PARAMS           16
+#define MOCK_MAX_LINK_DEPTH       16
+#define MOCK_MAX_HEADER_SIZE      (64 * 1024)
+#define MOCK_RECV_SIZE            (64 * 1024)
+#define MOCK_INITIAL_NBUCKETS     1024
+#define MOCK_OBJECT_REF_SIZE      48
+#define MOCK_LISTEN_BACKLOG       64
+#define MOCK_MAX_LISTENERS        8
+#define MOCK_MAX_CODINGS          8
+#define MOCK_CODING_SHUFFLE       "x-shuffle"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef enum {
+    MOCK_GROUP,
+    MOCK_DATASET,
+    MOCK_DATATYPE
+} mock_obj_type_t;
+
+typedef enum {
+    MOCK_LINK_HARD,
+    MOCK_LINK_SOFT,
+    MOCK_LINK_EXTERNAL
+} mock_link_class_t;
+
+typedef enum {
+    MOCK_SPACE_SIMPLE,
+    MOCK_SPACE_SCALAR,
+    MOCK_SPACE_NULL
+} mock_space_class_t;
+
+/* A growable byte buffer used for building responses and receiving requests */
+typedef struct mock_buf_t {
+    char   *data;
+    size_t  len;
+    size_t  nalloc;
+    int     failed;
+} mock_buf_t;
+
+typedef struct mock_shape_t {
+    mock_space_class_t space_class;
+    int                ndims;
+    int                has_maxdims;
+    uint64_t           dims[MOCK_MAX_DIMS];
+    uint64_t           maxdims[MOCK_MAX_DIMS];
+} mock_shape_t;
+
+typedef struct mock_link_t {
+    char              *name;
+    mock_link_class_t  link_class;
+    char               id[MOCK_ID_LENGTH];
+    char              *h5path;
+    char              *h5domain;
+    double             created;
+} mock_link_t;
+
+typedef struct mock_attr_t {
+    char         *name;
+    char         *type_json;
+    mock_shape_t  shape;
+    size_t        elem_size;
+    char         *data;
+    double        created;
+} mock_attr_t;
+
+typedef struct mock_domain_t {
+    char                 *name;
+    char                  root_id[MOCK_ID_LENGTH];
+    double                created;
+    struct mock_domain_t *next;
+} mock_domain_t;
+
+typedef struct mock_object_t {
+    char                  id[MOCK_ID_LENGTH];
+    mock_obj_type_t       obj_type;
+    mock_domain_t        *domain;
+    double                created;
+    double                last_modified;
+
+    /* Groups */
+    mock_link_t          *links;
+    size_t                nlinks;
+    size_t                links_nalloc;
+
+    /* All object types */
+    mock_attr_t          *attrs;
+    size_t                nattrs;
+    size_t                attrs_nalloc;
+
+    /* Datasets and committed datatypes */
+    char                 *type_json;
+    size_t                elem_size;
+
+    /* Datasets */
+    char                 *cprops_json;
+    mock_shape_t          shape;
+    char                 *data;
+
+    struct mock_object_t *hash_next;
+} mock_object_t;
+
+/* One of the ports the server listens on, along with the faults injected
+ * into the responses to requests made on it and its own request totals,
+ * both of which are protected by the server's lock
+ */
+typedef struct mock_listener_t {
+    rv_mock_hsds_t         *server;
+    int                     fd;
+    unsigned short          port;
+    pthread_t               thread;
+    rv_mock_hsds_faults_t   faults;
+    rv_mock_hsds_stats_t    stats;
+    uint64_t                requests_in_flight;
+} mock_listener_t;
+
+struct rv_mock_hsds_t {
+    rv_mock_hsds_config_t   config;
+
+    /* Object store, protected by lock */
+    pthread_mutex_t         lock;
+    mock_domain_t          *domains;
+    mock_object_t         **buckets;
+    size_t                  nbuckets;
+    size_t                  nobjects;
+    uint64_t                next_id;
+    rv_mock_hsds_stats_t    stats;
+    uint64_t                requests_in_flight;
+
+    /* Socket layer */
+    mock_listener_t         listeners[MOCK_MAX_LISTENERS];
+    size_t                  nlisteners;
+    int                     running;
+    pthread_mutex_t         conn_lock;
+    pthread_cond_t          conn_cond;
+    int                    *conn_fds;
+    size_t                  nconns;
+    size_t                  conns_nalloc;
+};
+
+/* Per-request state used while dispatching a request */
+typedef struct mock_param_t {
+    char *key;
+    char *value;
+} mock_param_t;
+
+typedef struct mock_ctx_t {
+    rv_mock_hsds_t               *server;
+    const rv_mock_hsds_request_t *request;
+    rv_mock_hsds_response_t      *response;
+    char                         *segs[MOCK_MAX_SEGMENTS];
+    size_t                        nsegs;
+    mock_param_t                  params[MOCK_MAX_PARAMS];
+    size_t                        nparams;
+    mock_domain_t                *domain;
+    yajl_val                      body;
+} mock_ctx_t;
+
+typedef struct mock_conn_args_t {
+    mock_listener_t *listener;
+    int              fd;
+} mock_conn_args_t;
+
+
+/*-------------------------------------------------------------------------
+ *                           Buffer helpers
+ *-------------------------------------------------------------------------
+ */
+
+static int
+mock_buf_reserve(mock_buf_t *buf, size_t extra)
+{
+    size_t  new_size;
+    char   *tmp;
+
+    if (buf->failed)
+        return -1;
+
+    if (buf->len + extra + 1 <= buf->nalloc)
+        return 0;
+
+    new_size = buf->nalloc ? buf->nalloc : 256;
+    while (new_size < buf->len + extra + 1)
+        new_size *= 2;
+
+    if (NULL == (tmp = (char *) realloc(buf->data, new_size))) {
+        buf->failed = 1;
+        return -1;
+    } /* end if */
+
+    buf->data = tmp;
+    buf->nalloc = new_size;
+
+    return 0;
+} /* end mock_buf_reserve() */
+
+static void
+mock_buf_append(mock_buf_t *buf, const void *data, size_t len)
+{
+    if (mock_buf_reserve(buf, len) < 0)
+        return;
+
+    if (len)
+        memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    buf->data[buf->len] = '\0';
+} /* end mock_buf_append() */
+
+static void
+mock_buf_puts(mock_buf_t *buf, const char *str)
+{
+    mock_buf_append(buf, str, strlen(str));
+} /* end mock_buf_puts() */
+
+static void
+mock_buf_printf(mock_buf_t *buf, const char *fmt, ...)
+{
+    va_list ap;
+    char    small[256];
+    int     len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(small, sizeof(small), fmt, ap);
+    va_end(ap);
+
+    if (len < 0) {
+        buf->failed = 1;
+        return;
+    } /* end if */
+
+    if ((size_t) len < sizeof(small)) {
+        mock_buf_append(buf, small, (size_t) len);
+        return;
+    } /* end if */
+
+    if (mock_buf_reserve(buf, (size_t) len) < 0)
+        return;
+
+    va_start(ap, fmt);
+    vsnprintf(buf->data + buf->len, (size_t) len + 1, fmt, ap);
+    va_end(ap);
+
+    buf->len += (size_t) len;
+} /* end mock_buf_printf() */
+
+static void
+mock_buf_consume(mock_buf_t *buf, size_t len)
+{
+    if (len >= buf->len) {
+        buf->len = 0;
+    }
+    else {
+        memmove(buf->data, buf->data + len, buf->len - len);
+        buf->len -= len;
+    } /* end else */
+
+    if (buf->data)
+        buf->data[buf->len] = '\0';
+} /* end mock_buf_consume() */
+
+
+/*-------------------------------------------------------------------------
+ *                           JSON output helpers
+ *-------------------------------------------------------------------------
+ */
+
+static void
+mock_json_string(mock_buf_t *buf, const char *str)
+{
+    const unsigned char *p;
+
+    mock_buf_puts(buf, "\"");
+    for (p = (const unsigned char *) str; *p; p++) {
+        switch (*p) {
+            case '"':  mock_buf_puts(buf, "\\\""); break;
+            case '\\': mock_buf_puts(buf, "\\\\"); break;
+            case '\n': mock_buf_puts(buf, "\\n"); break;
+            case '\r': mock_buf_puts(buf, "\\r"); break;
+            case '\t': mock_buf_puts(buf, "\\t"); break;
+            default:
+                if (*p < 0x20)
+                    mock_buf_printf(buf, "\\u%04x", *p);
+                else
+                    mock_buf_append(buf, p, 1);
+                break;
+        } /* end switch */
+    } /* end for */
+    mock_buf_puts(buf, "\"");
+} /* end mock_json_string() */
+
+/* Re-serializes a parsed JSON value, used to echo back datatypes and
+ * creation properties exactly as the client sent them.
+ */
+static void
+mock_json_value(mock_buf_t *buf, yajl_val val)
+{
+    size_t i;
+
+    if (!val) {
+        mock_buf_puts(buf, "null");
+        return;
+    } /* end if */
+
+    switch (val->type) {
+        case yajl_t_string:
+            mock_json_string(buf, YAJL_GET_STRING(val));
+            break;
+
+        case yajl_t_number:
+            mock_buf_puts(buf, YAJL_GET_NUMBER(val));
+            break;
+
+        case yajl_t_object:
+            mock_buf_puts(buf, "{");
+            for (i = 0; i < val->u.object.len; i++) {
+                if (i > 0) mock_buf_puts(buf, ", ");
+                mock_json_string(buf, val->u.object.keys[i]);
+                mock_buf_puts(buf, ": ");
+                mock_json_value(buf, val->u.object.values[i]);
+            } /* end for */
+            mock_buf_puts(buf, "}");
+            break;
+
+        case yajl_t_array:
+            mock_buf_puts(buf, "[");
+            for (i = 0; i < val->u.array.len; i++) {
+                if (i > 0) mock_buf_puts(buf, ", ");
+                mock_json_value(buf, val->u.array.values[i]);
+            } /* end for */
+            mock_buf_puts(buf, "]");
+            break;
+
+        case yajl_t_true:
+            mock_buf_puts(buf, "true");
+            break;
+
+        case yajl_t_false:
+            mock_buf_puts(buf, "false");
+            break;
+
+        case yajl_t_null:
+        case yajl_t_any:
+        default:
+            mock_buf_puts(buf, "null");
+            break;
+    } /* end switch */
+} /* end mock_json_value() */
+
+static char *
+mock_json_to_string(yajl_val val)
+{
+    mock_buf_t buf = { NULL, 0, 0, 0 };
+
+    mock_json_value(&buf, val);
+    if (buf.failed) {
+        free(buf.data);
+        return NULL;
+    } /* end if */
+
+    return buf.data;
+} /* end mock_json_to_string() */
+
+static yajl_val
+mock_json_get(yajl_val obj, const char *key)
+{
+    size_t i;
+
+    if (!YAJL_IS_OBJECT(obj))
+        return NULL;
+
+    for (i = 0; i < obj->u.object.len; i++)
+        if (!strcmp(obj->u.object.keys[i], key))
+            return obj->u.object.values[i];
+
+    return NULL;
+} /* end mock_json_get() */
+
+
+/*-------------------------------------------------------------------------
+ *                           Miscellaneous helpers
+ *-------------------------------------------------------------------------
+ */
+
+static double
+mock_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+
+    return (double) tv.tv_sec + ((double) tv.tv_usec / 1e6);
+} /* end mock_now() */
+
+static char *
+mock_strdup(const char *str)
+{
+    size_t  len = strlen(str);
+    char   *out;
+
+    if (NULL == (out = (char *) malloc(len + 1)))
+        return NULL;
+    memcpy(out, str, len + 1);
+
+    return out;
+} /* end mock_strdup() */
+
+static int
+mock_hex_value(int c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+} /* end mock_hex_value() */
+
+/* Decodes len bytes of a percent-encoded string into a newly-allocated string */
+static char *
+mock_url_decode(const char *str, size_t len)
+{
+    size_t  i, j;
+    char   *out;
+
+    if (NULL == (out = (char *) malloc(len + 1)))
+        return NULL;
+
+    for (i = 0, j = 0; i < len; i++) {
+        if (str[i] == '%' && i + 2 < len && mock_hex_value(str[i + 1]) >= 0 && mock_hex_value(str[i + 2]) >= 0) {
+            out[j++] = (char) ((mock_hex_value(str[i + 1]) << 4) | mock_hex_value(str[i + 2]));
+            i += 2;
+        } /* end if */
+        else
+            out[j++] = str[i];
+    } /* end for */
+    out[j] = '\0';
+
+    return out;
+} /* end mock_url_decode() */
+
+static int
+mock_base64_decode(const char *in, char **out, size_t *out_len)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t accum = 0;
+    size_t   in_len = strlen(in);
+    size_t   nbits = 0;
+    size_t   i, j = 0;
+    char    *buf;
+
+    if (NULL == (buf = (char *) malloc((in_len / 4) * 3 + 3)))
+        return -1;
+
+    for (i = 0; i < in_len; i++) {
+        const char *pos;
+
+        if (in[i] == '=')
+            break;
+
+        /* The REST VOL sends the URL-safe alphabet, which HSDS also accepts */
+        if (in[i] == '-')
+            pos = alphabet + 62;
+        else if (in[i] == '_')
+            pos = alphabet + 63;
+        else if (!in[i] || NULL == (pos = strchr(alphabet, in[i]))) {
+            free(buf);
+            return -1;
+        } /* end if */
+
+        accum = (accum << 6) | (uint32_t) (pos - alphabet);
+        nbits += 6;
+        if (nbits >= 8) {
+            nbits -= 8;
+            buf[j++] = (char) ((accum >> nbits) & 0xFF);
+        } /* end if */
+    } /* end for */
+
+    *out = buf;
+    *out_len = j;
+
+    return 0;
+} /* end mock_base64_decode() */
+
+/* Returns whether a comma-separated list of content codings, such as the
+ * value of an Accept-Encoding header, includes the given coding
+ */
+static int
+mock_has_coding(const char *list, const char *coding)
+{
+    size_t coding_len = strlen(coding);
+
+    while (list && *list) {
+        size_t len;
+
+        list += strspn(list, ", \t");
+        len = strcspn(list, ",; \t");
+        if (len == coding_len && !strncasecmp(list, coding, len))
+            return 1;
+        list = strchr(list, ',');
+    } /* end while */
+
+    return 0;
+} /* end mock_has_coding() */
+
+/* Byte-shuffles data made up of elements of the given size in the same way as
+ * the REST VOL, or undoes the shuffle if unshuffle is set
+ */
+static void
+mock_shuffle(const char *src, char *dst, size_t len, size_t elem_size, int unshuffle)
+{
+    size_t nelmts = len / elem_size;
+    size_t i, j;
+
+    for (j = 0; j < elem_size; j++)
+        for (i = 0; i < nelmts; i++) {
+            if (unshuffle)
+                dst[i * elem_size + j] = src[j * nelmts + i];
+            else
+                dst[j * nelmts + i] = src[i * elem_size + j];
+        } /* end for */
+
+    memcpy(dst + nelmts * elem_size, src + nelmts * elem_size, len - nelmts * elem_size);
+} /* end mock_shuffle() */
+
+/* Undoes the content encodings of a dataset value sent by a client, in the
+ * reverse of the order they are listed in, into a newly-allocated buffer.
+ * The decoded value must be value_len bytes long. Fails for an unsupported
+ * coding or corrupt data.
+ */
+static int
+mock_decode_value(const char *encoding, const char *in, size_t in_len, size_t elem_size, size_t value_len, char **out)
+{
+    const char *codings[MOCK_MAX_CODINGS];
+    size_t      ncodings = 0;
+    size_t      len = in_len;
+    char       *list = NULL;
+    char       *coding;
+    char       *buf = NULL;
+    char       *tmp = NULL;
+
+    if (NULL == (list = mock_strdup(encoding)))
+        goto error;
+    for (coding = strtok(list, ", \t"); coding; coding = strtok(NULL, ", \t")) {
+        if (ncodings == MOCK_MAX_CODINGS)
+            goto error;
+        codings[ncodings++] = coding;
+    } /* end for */
+
+    if (NULL == (buf = (char *) malloc(in_len ? in_len : 1)))
+        goto error;
+    memcpy(buf, in, in_len);
+
+    while (ncodings) {
+        const char *cur_coding = codings[--ncodings];
+
+        if (!strcasecmp(cur_coding, "identity"))
+            continue;
+
+        if (!strcasecmp(cur_coding, MOCK_CODING_SHUFFLE)) {
+            if (NULL == (tmp = (char *) malloc(len ? len : 1)))
+                goto error;
+            mock_shuffle(buf, tmp, len, elem_size, 1);
+        } /* end if */
+#ifdef RV_HAVE_ZLIB
+        else if (!strcasecmp(cur_coding, "deflate")) {
+            uLongf tmp_len = (uLongf) value_len;
+
+            if (NULL == (tmp = (char *) malloc(value_len ? value_len : 1)))
+                goto error;
+            if (Z_OK != uncompress((Bytef *) tmp, &tmp_len, (const Bytef *) buf, (uLong) len) || tmp_len != value_len)
+                goto error;
+            len = (size_t) tmp_len;
+        } /* end else if */
+#endif
+        else
+            goto error;
+
+        free(buf);
+        buf = tmp;
+        tmp = NULL;
+    } /* end while */
+
+    if (len != value_len)
+        goto error;
+
+    free(list);
+    *out = buf;
+
+    return 0;
+
+error:
+    free(list);
+    free(buf);
+    free(tmp);
+
+    return -1;
+} /* end mock_decode_value() */
+
+/* Compresses the dataset value in a response body in place with the content
+ * encodings that the client accepts, if the server has been told to compress
+ * values and doing so makes the body smaller
+ */
+static void
+mock_encode_value(const rv_mock_hsds_config_t *config, const char *accept_encoding, size_t elem_size,
+                  mock_buf_t *body, const char **content_encoding)
+{
+#ifdef RV_HAVE_ZLIB
+    uLong   bound;
+    uLongf  out_len;
+    char   *shuffled = NULL;
+    char   *out = NULL;
+    int     shuffle;
+
+    *content_encoding = NULL;
+
+    if (!config->compress_values || !body->len || body->failed || !mock_has_coding(accept_encoding, "deflate"))
+        return;
+
+    shuffle = elem_size > 1 && mock_has_coding(accept_encoding, MOCK_CODING_SHUFFLE);
+    if (shuffle) {
+        if (NULL == (shuffled = (char *) malloc(body->len)))
+            return;
+        mock_shuffle(body->data, shuffled, body->len, elem_size, 0);
+    } /* end if */
+
+    out_len = bound = compressBound((uLong) body->len);
+    if (NULL == (out = (char *) malloc(bound)))
+        goto done;
+    if (Z_OK != compress((Bytef *) out, &out_len, (const Bytef *) (shuffle ? shuffled : body->data), (uLong) body->len)
+            || out_len >= body->len)
+        goto done;
+
+    free(body->data);
+    body->data = out;
+    body->len = (size_t) out_len;
+    body->nalloc = (size_t) bound;
+    out = NULL;
+
+    *content_encoding = shuffle ? MOCK_CODING_SHUFFLE ", deflate" : "deflate";
+
+done:
+    free(shuffled);
+    free(out);
+#else
+    *content_encoding = NULL;
+#endif
+} /* end mock_encode_value() */
+
+static const char *
+mock_collection_name(mock_obj_type_t obj_type)
+{
+    switch (obj_type) {
+        case MOCK_GROUP:    return "groups";
+        case MOCK_DATASET:  return "datasets";
+        case MOCK_DATATYPE: return "datatypes";
+        default:            return "unknown";
+    } /* end switch */
+} /* end mock_collection_name() */
+
+
+/*-------------------------------------------------------------------------
+ *                           Datatypes and dataspaces
+ *-------------------------------------------------------------------------
+ */
+
+static mock_object_t *mock_find_object(rv_mock_hsds_t *server, mock_domain_t *domain, const char *id);
+
+static size_t
+mock_predefined_type_size(const char *name)
+{
+    const char *bits = NULL;
+
+    if (!strcmp(name, "H5T_STD_REF_OBJ"))
+        return MOCK_OBJECT_REF_SIZE;
+
+    if (!strncmp(name, "H5T_STD_I", 9) || !strncmp(name, "H5T_STD_U", 9))
+        bits = name + 9;
+    else if (!strncmp(name, "H5T_IEEE_F", 10))
+        bits = name + 10;
+
+    if (!bits || !isdigit((unsigned char) *bits))
+        return 0;
+
+    return (size_t) strtoul(bits, NULL, 10) / 8;
+} /* end mock_predefined_type_size() */
+
+/* Computes the size of one element of the given JSON datatype, as the REST
+ * VOL lays it out for binary transfers. Returns 0 for datatypes that have
+ * no fixed size (variable-length data) or that aren't understood.
+ */
+static size_t
+mock_type_size(rv_mock_hsds_t *server, mock_domain_t *domain, yajl_val type)
+{
+    const char *type_class;
+    yajl_val    val;
+    size_t      i, size;
+
+    if (YAJL_IS_STRING(type)) {
+        const char    *name = YAJL_GET_STRING(type);
+        mock_object_t *obj;
+
+        if (!strncmp(name, "t-", 2))
+            return (obj = mock_find_object(server, domain, name)) && obj->obj_type == MOCK_DATATYPE ? obj->elem_size : 0;
+
+        return mock_predefined_type_size(name);
+    } /* end if */
+
+    if (!YAJL_IS_OBJECT(type) || NULL == (type_class = YAJL_GET_STRING(mock_json_get(type, "class"))))
+        return 0;
+
+    if (!strcmp(type_class, "H5T_INTEGER") || !strcmp(type_class, "H5T_FLOAT")
+            || !strcmp(type_class, "H5T_ENUM") || !strcmp(type_class, "H5T_REFERENCE"))
+        return mock_type_size(server, domain, mock_json_get(type, "base"));
+
+    if (!strcmp(type_class, "H5T_STRING")) {
+        val = mock_json_get(type, "length");
+        return YAJL_IS_INTEGER(val) ? (size_t) YAJL_GET_INTEGER(val) : 0;
+    } /* end if */
+
+    if (!strcmp(type_class, "H5T_OPAQUE")) {
+        val = mock_json_get(type, "size");
+        return YAJL_IS_INTEGER(val) ? (size_t) YAJL_GET_INTEGER(val) : 0;
+    } /* end if */
+
+    if (!strcmp(type_class, "H5T_COMPOUND")) {
+        val = mock_json_get(type, "fields");
+        if (!YAJL_IS_ARRAY(val))
+            return 0;
+
+        for (i = 0, size = 0; i < val->u.array.len; i++) {
+            size_t field_size = mock_type_size(server, domain, mock_json_get(val->u.array.values[i], "type"));
+
+            if (!field_size)
+                return 0;
+            size += field_size;
+        } /* end for */
+
+        return size;
+    } /* end if */
+
+    if (!strcmp(type_class, "H5T_ARRAY")) {
+        val = mock_json_get(type, "dims");
+        if (!YAJL_IS_ARRAY(val))
+            return 0;
+
+        size = mock_type_size(server, domain, mock_json_get(type, "base"));
+        for (i = 0; i < val->u.array.len; i++)
+            size *= YAJL_IS_INTEGER(val->u.array.values[i]) ? (size_t) YAJL_GET_INTEGER(val->u.array.values[i]) : 0;
+
+        return size;
+    } /* end if */
+
+    return 0;
+} /* end mock_type_size() */
+
+/* Parses the "shape" and "maxdims" of a create request. A missing shape
+ * means a scalar dataspace.
+ */
+static int
+mock_parse_shape(yajl_val shape, yajl_val maxdims, mock_shape_t *out)
+{
+    size_t i;
+
+    memset(out, 0, sizeof(*out));
+
+    if (!shape || YAJL_IS_NULL(shape)) {
+        out->space_class = MOCK_SPACE_SCALAR;
+        return 0;
+    } /* end if */
+
+    if (YAJL_IS_STRING(shape)) {
+        if (!strcmp(shape->u.string, "H5S_NULL"))
+            out->space_class = MOCK_SPACE_NULL;
+        else if (!strcmp(shape->u.string, "H5S_SCALAR"))
+            out->space_class = MOCK_SPACE_SCALAR;
+        else
+            return -1;
+        return 0;
+    } /* end if */
+
+    if (!YAJL_IS_ARRAY(shape) || !shape->u.array.len || shape->u.array.len > MOCK_MAX_DIMS)
+        return -1;
+
+    out->space_class = MOCK_SPACE_SIMPLE;
+    out->ndims = (int) shape->u.array.len;
+    for (i = 0; i < shape->u.array.len; i++) {
+        if (!YAJL_IS_INTEGER(shape->u.array.values[i]) || YAJL_GET_INTEGER(shape->u.array.values[i]) < 0)
+            return -1;
+        out->dims[i] = (uint64_t) YAJL_GET_INTEGER(shape->u.array.values[i]);
+    } /* end for */
+
+    if (YAJL_IS_ARRAY(maxdims)) {
+        if (maxdims->u.array.len != shape->u.array.len)
+            return -1;
+
+        out->has_maxdims = 1;
+        for (i = 0; i < maxdims->u.array.len; i++) {
+            if (!YAJL_IS_INTEGER(maxdims->u.array.values[i]))
+                return -1;
+            out->maxdims[i] = (uint64_t) YAJL_GET_INTEGER(maxdims->u.array.values[i]);
+        } /* end for */
+    } /* end if */
+
+    return 0;
+} /* end mock_parse_shape() */
+
+static uint64_t
+mock_shape_nelmts(const mock_shape_t *shape)
+{
+    uint64_t nelmts = 1;
+    int      i;
+
+    if (shape->space_class == MOCK_SPACE_NULL)
+        return 0;
+
+    for (i = 0; i < shape->ndims; i++)
+        nelmts *= shape->dims[i];
+
+    return nelmts;
+} /* end mock_shape_nelmts() */
+
+static void
+mock_write_shape(mock_buf_t *buf, const mock_shape_t *shape)
+{
+    int i;
+
+    if (shape->space_class == MOCK_SPACE_NULL) {
+        mock_buf_puts(buf, "{\"class\": \"H5S_NULL\"}");
+        return;
+    } /* end if */
+
+    if (shape->space_class == MOCK_SPACE_SCALAR) {
+        mock_buf_puts(buf, "{\"class\": \"H5S_SCALAR\"}");
+        return;
+    } /* end if */
+
+    mock_buf_puts(buf, "{\"class\": \"H5S_SIMPLE\", \"dims\": [");
+    for (i = 0; i < shape->ndims; i++)
+        mock_buf_printf(buf, "%s%llu", i ? ", " : "", (unsigned long long) shape->dims[i]);
+    mock_buf_puts(buf, "]");
+
+    if (shape->has_maxdims) {
+        mock_buf_puts(buf, ", \"maxdims\": [");
+        for (i = 0; i < shape->ndims; i++)
+            mock_buf_printf(buf, "%s%llu", i ? ", " : "", (unsigned long long) shape->maxdims[i]);
+        mock_buf_puts(buf, "]");
+    } /* end if */
+
+    mock_buf_puts(buf, "}");
+} /* end mock_write_shape() */
+
+/* Parses a "select" request parameter of the form [start:stop:step, ...]
+ * into per-dimension start, count and step values. Without a selection,
+ * the whole extent is selected.
+ */
+static int
+mock_parse_select(const char *select, const mock_shape_t *shape, uint64_t *start, uint64_t *count, uint64_t *step)
+{
+    const char *p = select;
+    int         i;
+
+    for (i = 0; i < shape->ndims; i++) {
+        start[i] = 0;
+        count[i] = shape->dims[i];
+        step[i] = 1;
+    } /* end for */
+
+    /* Like HSDS, an empty selection selects the whole dataset */
+    if (!select || !*select)
+        return 0;
+
+    if (shape->space_class != MOCK_SPACE_SIMPLE)
+        return -1;
+
+    while (isspace((unsigned char) *p)) p++;
+    if (*p++ != '[')
+        return -1;
+
+    for (i = 0; i < shape->ndims; i++) {
+        unsigned long long first, last, stride = 1;
+        char              *end;
+
+        while (isspace((unsigned char) *p)) p++;
+        first = strtoull(p, &end, 10);
+        if (end == p)
+            return -1;
+        p = end;
+        last = first + 1;
+
+        if (*p == ':') {
+            p++;
+            last = strtoull(p, &end, 10);
+            if (end == p)
+                return -1;
+            p = end;
+
+            if (*p == ':') {
+                p++;
+                stride = strtoull(p, &end, 10);
+                if (end == p || !stride)
+                    return -1;
+                p = end;
+            } /* end if */
+        } /* end if */
+
+        if (first >= last || last > shape->dims[i])
+            return -1;
+
+        start[i] = first;
+        count[i] = (last - first + stride - 1) / stride;
+        step[i] = stride;
+
+        while (isspace((unsigned char) *p)) p++;
+        if (*p == ',')
+            p++;
+    } /* end for */
+
+    while (isspace((unsigned char) *p)) p++;
+
+    return *p == ']' ? 0 : -1;
+} /* end mock_parse_select() */
+
+/* Copies a regular hyperslab selection between the dataset buffer and a
+ * packed transfer buffer, moving the fastest-changing dimension as a
+ * single run when it is contiguous.
+ */
+static void
+mock_copy_selection(char *data, const mock_shape_t *shape, size_t elem_size, const uint64_t *start,
+    const uint64_t *count, const uint64_t *step, char *packed, int to_dataset)
+{
+    uint64_t strides[MOCK_MAX_DIMS];
+    uint64_t idx[MOCK_MAX_DIMS];
+    uint64_t run, nruns, r;
+    int      ndims = shape->ndims;
+    int      last, i;
+
+    if (shape->space_class == MOCK_SPACE_SCALAR) {
+        if (to_dataset)
+            memcpy(data, packed, elem_size);
+        else
+            memcpy(packed, data, elem_size);
+        return;
+    } /* end if */
+
+    for (i = 0, nruns = 1; i < ndims; i++)
+        nruns *= count[i];
+    if (!nruns)
+        return;
+
+    strides[ndims - 1] = 1;
+    for (i = ndims - 2; i >= 0; i--)
+        strides[i] = strides[i + 1] * shape->dims[i + 1];
+
+    run = (step[ndims - 1] == 1) ? count[ndims - 1] : 1;
+    last = (step[ndims - 1] == 1) ? ndims - 2 : ndims - 1;
+    nruns /= run;
+
+    memset(idx, 0, sizeof(idx));
+    for (r = 0; r < nruns; r++) {
+        uint64_t offset = 0;
+
+        for (i = 0; i < ndims; i++)
+            offset += (start[i] + idx[i] * step[i]) * strides[i];
+
+        if (to_dataset)
+            memcpy(data + offset * elem_size, packed, run * elem_size);
+        else
+            memcpy(packed, data + offset * elem_size, run * elem_size);
+        packed += run * elem_size;
+
+        for (i = last; i >= 0; i--) {
+            if (++idx[i] < count[i])
+                break;
+            idx[i] = 0;
+        } /* end for */
+    } /* end for */
+} /* end mock_copy_selection() */
+
+/* Converts a JSON point list into element offsets within the dataset */
+static int
+mock_parse_points(yajl_val points, const mock_shape_t *shape, uint64_t **offsets_out, size_t *npoints_out)
+{
+    uint64_t *offsets;
+    size_t    i;
+    int       j;
+
+    if (!YAJL_IS_ARRAY(points) || shape->space_class != MOCK_SPACE_SIMPLE)
+        return -1;
+
+    if (NULL == (offsets = (uint64_t *) malloc((points->u.array.len + 1) * sizeof(*offsets))))
+        return -1;
+
+    for (i = 0; i < points->u.array.len; i++) {
+        yajl_val point = points->u.array.values[i];
+        uint64_t offset = 0;
+
+        if (YAJL_IS_INTEGER(point) && shape->ndims == 1) {
+            if ((uint64_t) YAJL_GET_INTEGER(point) >= shape->dims[0])
+                goto error;
+            offset = (uint64_t) YAJL_GET_INTEGER(point);
+        } /* end if */
+        else if (YAJL_IS_ARRAY(point) && point->u.array.len == (size_t) shape->ndims) {
+            for (j = 0; j < shape->ndims; j++) {
+                yajl_val coord = point->u.array.values[j];
+
+                if (!YAJL_IS_INTEGER(coord) || (uint64_t) YAJL_GET_INTEGER(coord) >= shape->dims[j])
+                    goto error;
+                offset = offset * shape->dims[j] + (uint64_t) YAJL_GET_INTEGER(coord);
+            } /* end for */
+        } /* end else if */
+        else
+            goto error;
+
+        offsets[i] = offset;
+    } /* end for */
+
+    *offsets_out = offsets;
+    *npoints_out = points->u.array.len;
+
+    return 0;
+
+error:
+    free(offsets);
+    return -1;
+} /* end mock_parse_points() */
+
+
+/*-------------------------------------------------------------------------
+ *                           Object store
+ *-------------------------------------------------------------------------
+ */
+
+static size_t
+mock_hash(const char *str)
+{
+    size_t hash = 2166136261u;
+
+    while (*str)
+        hash = (hash ^ (unsigned char) *str++) * 16777619u;
+
+    return hash;
+} /* end mock_hash() */
+
+static mock_domain_t *
+mock_find_domain(rv_mock_hsds_t *server, const char *name)
+{
+    mock_domain_t *domain;
+
+    for (domain = server->domains; domain; domain = domain->next)
+        if (!strcmp(domain->name, name))
+            return domain;
+
+    return NULL;
+} /* end mock_find_domain() */
+
+/* Looks up an object by ID, only returning objects belonging to the given domain */
+static mock_object_t *
+mock_find_object(rv_mock_hsds_t *server, mock_domain_t *domain, const char *id)
+{
+    mock_object_t *obj;
+
+    for (obj = server->buckets[mock_hash(id) & (server->nbuckets - 1)]; obj; obj = obj->hash_next)
+        if (!strcmp(obj->id, id))
+            return (obj->domain == domain) ? obj : NULL;
+
+    return NULL;
+} /* end mock_find_object() */
+
+static int
+mock_grow_buckets(rv_mock_hsds_t *server)
+{
+    mock_object_t **new_buckets;
+    size_t          new_nbuckets = server->nbuckets * 2;
+    size_t          i;
+
+    if (NULL == (new_buckets = (mock_object_t **) calloc(new_nbuckets, sizeof(*new_buckets))))
+        return -1;
+
+    for (i = 0; i < server->nbuckets; i++) {
+        mock_object_t *obj = server->buckets[i];
+
+        while (obj) {
+            mock_object_t *next = obj->hash_next;
+            size_t         bucket = mock_hash(obj->id) & (new_nbuckets - 1);
+
+            obj->hash_next = new_buckets[bucket];
+            new_buckets[bucket] = obj;
+            obj = next;
+        } /* end while */
+    } /* end for */
+
+    free(server->buckets);
+    server->buckets = new_buckets;
+    server->nbuckets = new_nbuckets;
+
+    return 0;
+} /* end mock_grow_buckets() */
+
+static mock_object_t *
+mock_new_object(rv_mock_hsds_t *server, mock_domain_t *domain, mock_obj_type_t obj_type)
+{
+    mock_object_t *obj;
+    size_t         bucket;
+    uint64_t       serial;
+
+    if (server->nobjects >= server->nbuckets)
+        if (mock_grow_buckets(server) < 0)
+            return NULL;
+
+    if (NULL == (obj = (mock_object_t *) calloc(1, sizeof(*obj))))
+        return NULL;
+
+    /* Generate IDs shaped like HSDS UUIDs, with a prefix giving the collection */
+    serial = ++server->next_id;
+    snprintf(obj->id, sizeof(obj->id), "%c-%08x-%04x-%04x-%04x-%012llx",
+             obj_type == MOCK_GROUP ? 'g' : (obj_type == MOCK_DATASET ? 'd' : 't'),
+             (unsigned) (mock_hash(domain->name) & 0xFFFFFFFFu), 0x4d4fu, 0x434bu, 0x4853u,
+             (unsigned long long) serial);
+
+    obj->obj_type = obj_type;
+    obj->domain = domain;
+    obj->created = obj->last_modified = mock_now();
+
+    bucket = mock_hash(obj->id) & (server->nbuckets - 1);
+    obj->hash_next = server->buckets[bucket];
+    server->buckets[bucket] = obj;
+    server->nobjects++;
+
+    return obj;
+} /* end mock_new_object() */
+
+static void
+mock_free_attr(mock_attr_t *attr)
+{
+    free(attr->name);
+    free(attr->type_json);
+    free(attr->data);
+} /* end mock_free_attr() */
+
+static void
+mock_free_link(mock_link_t *link)
+{
+    free(link->name);
+    free(link->h5path);
+    free(link->h5domain);
+} /* end mock_free_link() */
+
+static void
+mock_free_object(mock_object_t *obj)
+{
+    size_t i;
+
+    for (i = 0; i < obj->nlinks; i++)
+        mock_free_link(&obj->links[i]);
+    free(obj->links);
+
+    for (i = 0; i < obj->nattrs; i++)
+        mock_free_attr(&obj->attrs[i]);
+    free(obj->attrs);
+
+    free(obj->type_json);
+    free(obj->cprops_json);
+    free(obj->data);
+    free(obj);
+} /* end mock_free_object() */
+
+/* Removes every object for which match() returns true */
+static void
+mock_remove_objects(rv_mock_hsds_t *server, int (*match)(const mock_object_t *, const void *), const void *udata)
+{
+    size_t i;
+
+    for (i = 0; i < server->nbuckets; i++) {
+        mock_object_t **prev = &server->buckets[i];
+
+        while (*prev) {
+            mock_object_t *obj = *prev;
+
+            if (match(obj, udata)) {
+                *prev = obj->hash_next;
+                mock_free_object(obj);
+                server->nobjects--;
+            } /* end if */
+            else
+                prev = &obj->hash_next;
+        } /* end while */
+    } /* end for */
+} /* end mock_remove_objects() */
+
+static int
+mock_match_domain(const mock_object_t *obj, const void *udata)
+{
+    return obj->domain == (const mock_domain_t *) udata;
+} /* end mock_match_domain() */
+
+static int
+mock_match_object(const mock_object_t *obj, const void *udata)
+{
+    return obj == (const mock_object_t *) udata;
+} /* end mock_match_object() */
+
+static int
+mock_match_all(const mock_object_t *obj, const void *udata)
+{
+    (void) obj; (void) udata;
+    return 1;
+} /* end mock_match_all() */
+
+static mock_link_t *
+mock_find_link(mock_object_t *group, const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < group->nlinks; i++)
+        if (!strcmp(group->links[i].name, name))
+            return &group->links[i];
+
+    return NULL;
+} /* end mock_find_link() */
+
+static mock_link_t *
+mock_add_link(mock_object_t *group, const char *name)
+{
+    mock_link_t *link;
+
+    if (group->nlinks == group->links_nalloc) {
+        size_t       new_nalloc = group->links_nalloc ? group->links_nalloc * 2 : 8;
+        mock_link_t *tmp;
+
+        if (NULL == (tmp = (mock_link_t *) realloc(group->links, new_nalloc * sizeof(*tmp))))
+            return NULL;
+        group->links = tmp;
+        group->links_nalloc = new_nalloc;
+    } /* end if */
+
+    link = &group->links[group->nlinks];
+    memset(link, 0, sizeof(*link));
+    if (NULL == (link->name = mock_strdup(name)))
+        return NULL;
+    link->created = mock_now();
+
+    group->nlinks++;
+    group->last_modified = link->created;
+
+    return link;
+} /* end mock_add_link() */
+
+static mock_attr_t *
+mock_find_attr(mock_object_t *obj, const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < obj->nattrs; i++)
+        if (!strcmp(obj->attrs[i].name, name))
+            return &obj->attrs[i];
+
+    return NULL;
+} /* end mock_find_attr() */
+
+/* Follows an HDF5 path from the given group (or the root group for absolute
+ * paths), resolving soft links along the way. External links are not
+ * followed.
+ */
+static mock_object_t *
+mock_resolve_path(rv_mock_hsds_t *server, mock_domain_t *domain, mock_object_t *start, const char *path, int depth)
+{
+    mock_object_t *cur;
+    const char    *p = path;
+
+    if (depth > MOCK_MAX_LINK_DEPTH)
+        return NULL;
+
+    if (*p == '/' || !start)
+        cur = mock_find_object(server, domain, domain->root_id);
+    else
+        cur = start;
+
+    while (cur && *p) {
+        mock_link_t *link;
+        const char  *end;
+        char        *name;
+        size_t       len;
+
+        while (*p == '/') p++;
+        if (!*p)
+            break;
+
+        end = strchr(p, '/');
+        len = end ? (size_t) (end - p) : strlen(p);
+
+        if (len == 1 && *p == '.') {
+            p += len;
+            continue;
+        } /* end if */
+
+        if (cur->obj_type != MOCK_GROUP || NULL == (name = (char *) malloc(len + 1)))
+            return NULL;
+        memcpy(name, p, len);
+        name[len] = '\0';
+
+        link = mock_find_link(cur, name);
+        free(name);
+        if (!link)
+            return NULL;
+
+        switch (link->link_class) {
+            case MOCK_LINK_HARD:
+                cur = mock_find_object(server, domain, link->id);
+                break;
+
+            case MOCK_LINK_SOFT:
+                cur = mock_resolve_path(server, domain, cur, link->h5path, depth + 1);
+                break;
+
+            case MOCK_LINK_EXTERNAL:
+            default:
+                return NULL;
+        } /* end switch */
+
+        p += len;
+    } /* end while */
+
+    return cur;
+} /* end mock_resolve_path() */
+
+
+/*-------------------------------------------------------------------------
+ *                           Response helpers
+ *-------------------------------------------------------------------------
+ */
+
+static void
+mock_reply(mock_ctx_t *ctx, int status, mock_buf_t *body, const char *content_type)
+{
+    if (body && body->failed) {
+        free(body->data);
+        body->data = NULL;
+        body->len = 0;
+        status = 500;
+        content_type = "application/json";
+    } /* end if */
+
+    ctx->response->status = status;
+    ctx->response->content_type = content_type;
+    ctx->response->body = body ? body->data : NULL;
+    ctx->response->body_len = body ? body->len : 0;
+} /* end mock_reply() */
+
+static void
+mock_reply_json(mock_ctx_t *ctx, int status, mock_buf_t *body)
+{
+    mock_reply(ctx, status, body, "application/json");
+} /* end mock_reply_json() */
+
+static void
+mock_reply_error(mock_ctx_t *ctx, int status, const char *message)
+{
+    mock_buf_t body = { NULL, 0, 0, 0 };
+
+    mock_buf_puts(&body, "{\"message\": ");
+    mock_json_string(&body, message);
+    mock_buf_puts(&body, "}");
+
+    mock_reply_json(ctx, status, &body);
+} /* end mock_reply_error() */
+
+static void
+mock_reply_empty(mock_ctx_t *ctx, int status)
+{
+    mock_buf_t body = { NULL, 0, 0, 0 };
+
+    mock_buf_puts(&body, "{}");
+    mock_reply_json(ctx, status, &body);
+} /* end mock_reply_empty() */
+
+static const char *
+mock_param(const mock_ctx_t *ctx, const char *key)
+{
+    size_t i;
+
+    for (i = 0; i < ctx->nparams; i++)
+        if (!strcmp(ctx->params[i].key, key))
+            return ctx->params[i].value;
+
+    return NULL;
+} /* end mock_param() */
+
+static void
+mock_write_hrefs(mock_buf_t *buf, const mock_object_t *obj)
+{
+    mock_buf_printf(buf, "\"hrefs\": [{\"rel\": \"self\", \"href\": \"/%s/%s\"}, "
+                         "{\"rel\": \"root\", \"href\": \"/groups/%s\"}, "
+                         "{\"rel\": \"home\", \"href\": \"/\"}]",
+                    mock_collection_name(obj->obj_type), obj->id, obj->domain->root_id);
+} /* end mock_write_hrefs() */
+
+static void
+mock_write_object(mock_buf_t *buf, const mock_object_t *obj)
+{
+    mock_buf_puts(buf, "{");
+
+    /* The REST VOL looks for the first "type" key in the response when parsing
+     * datatypes, so it has to come before any nested occurrences.
+     */
+    if (obj->type_json)
+        mock_buf_printf(buf, "\"type\": %s, ", obj->type_json);
+
+    mock_buf_printf(buf, "\"id\": \"%s\", \"root\": \"%s\", \"domain\": ", obj->id, obj->domain->root_id);
+    mock_json_string(buf, obj->domain->name);
+    mock_buf_printf(buf, ", \"created\": %.3f, \"lastModified\": %.3f, \"attributeCount\": %zu, ",
+                    obj->created, obj->last_modified, obj->nattrs);
+
+    if (obj->obj_type == MOCK_GROUP)
+        mock_buf_printf(buf, "\"linkCount\": %zu, ", obj->nlinks);
+
+    if (obj->obj_type == MOCK_DATASET) {
+        mock_buf_puts(buf, "\"shape\": ");
+        mock_write_shape(buf, &obj->shape);
+        mock_buf_printf(buf, ", \"creationProperties\": %s, \"layout\": {\"class\": \"H5D_CONTIGUOUS\"}, ",
+                        obj->cprops_json ? obj->cprops_json : "{}");
+    } /* end if */
+
+    mock_write_hrefs(buf, obj);
+    mock_buf_puts(buf, "}");
+} /* end mock_write_object() */
+
+static void
+mock_write_link(mock_buf_t *buf, rv_mock_hsds_t *server, mock_domain_t *domain, const mock_link_t *link)
+{
+    mock_buf_puts(buf, "{\"title\": ");
+    mock_json_string(buf, link->name);
+    mock_buf_printf(buf, ", \"created\": %.3f, ", link->created);
+
+    switch (link->link_class) {
+        case MOCK_LINK_HARD:
+        {
+            mock_object_t *target = mock_find_object(server, domain, link->id);
+
+            mock_buf_printf(buf, "\"class\": \"H5L_TYPE_HARD\", \"id\": \"%s\", \"collection\": \"%s\"}",
+                            link->id, mock_collection_name(target ? target->obj_type : MOCK_GROUP));
+            break;
+        }
+
+        case MOCK_LINK_SOFT:
+            mock_buf_puts(buf, "\"class\": \"H5L_TYPE_SOFT\", \"h5path\": ");
+            mock_json_string(buf, link->h5path);
+            mock_buf_puts(buf, "}");
+            break;
+
+        case MOCK_LINK_EXTERNAL:
+        default:
+            mock_buf_puts(buf, "\"class\": \"H5L_TYPE_EXTERNAL\", \"h5path\": ");
+            mock_json_string(buf, link->h5path);
+            mock_buf_puts(buf, ", \"h5domain\": ");
+            mock_json_string(buf, link->h5domain);
+            mock_buf_puts(buf, "}");
+            break;
+    } /* end switch */
+} /* end mock_write_link() */
+
+static void
+mock_write_attr(mock_buf_t *buf, const mock_attr_t *attr)
+{
+    mock_buf_printf(buf, "{\"type\": %s, \"name\": ", attr->type_json);
+    mock_json_string(buf, attr->name);
+    mock_buf_puts(buf, ", \"shape\": ");
+    mock_write_shape(buf, &attr->shape);
+    mock_buf_printf(buf, ", \"created\": %.3f, \"lastModified\": %.3f}", attr->created, attr->created);
+} /* end mock_write_attr() */
+
+
+/*-------------------------------------------------------------------------
+ *                           Request handlers
+ *-------------------------------------------------------------------------
+ */
+
+static void
+mock_handle_domain(mock_ctx_t *ctx, const char *domain_name)
+{
+    rv_mock_hsds_t *server = ctx->server;
+    const char     *method = ctx->request->method;
+    mock_buf_t      body = { NULL, 0, 0, 0 };
+
+    if (!strcmp(method, "PUT")) {
+        mock_domain_t *domain;
+        mock_object_t *root;
+
+        if (ctx->domain) {
+            mock_reply_error(ctx, 409, "domain already exists");
+            return;
+        } /* end if */
+
+        if (NULL == (domain = (mock_domain_t *) calloc(1, sizeof(*domain)))
+                || NULL == (domain->name = mock_strdup(domain_name))) {
+            free(domain);
+            mock_reply_error(ctx, 500, "out of memory");
+            return;
+        } /* end if */
+
+        if (NULL == (root = mock_new_object(server, domain, MOCK_GROUP))) {
+            free(domain->name);
+            free(domain);
+            mock_reply_error(ctx, 500, "out of memory");
+            return;
+        } /* end if */
+
+        strcpy(domain->root_id, root->id);
+        domain->created = root->created;
+        domain->next = server->domains;
+        server->domains = domain;
+        ctx->domain = domain;
+    } /* end if */
+    else if (!strcmp(method, "DELETE")) {
+        mock_domain_t **prev;
+
+        if (!ctx->domain) {
+            mock_reply_error(ctx, 404, "domain not found");
+            return;
+        } /* end if */
+
+        mock_remove_objects(server, mock_match_domain, ctx->domain);
+
+        for (prev = &server->domains; *prev != ctx->domain; prev = &(*prev)->next)
+            ;
+        *prev = ctx->domain->next;
+
+        mock_buf_puts(&body, "{\"domain\": ");
+        mock_json_string(&body, ctx->domain->name);
+        mock_buf_puts(&body, "}");
+
+        free(ctx->domain->name);
+        free(ctx->domain);
+        ctx->domain = NULL;
+
+        mock_reply_json(ctx, 200, &body);
+        return;
+    } /* end else if */
+    else if (strcmp(method, "GET")) {
+        mock_reply_error(ctx, 405, "method not allowed on domain");
+        return;
+    } /* end else if */
+
+    if (!ctx->domain) {
+        mock_reply_error(ctx, 404, "domain not found");
+        return;
+    } /* end if */
+
+    mock_buf_printf(&body, "{\"root\": \"%s\", \"class\": \"domain\", \"owner\": \"mock\", "
+                           "\"created\": %.3f, \"lastModified\": %.3f, \"hrefs\": []}",
+                    ctx->domain->root_id, ctx->domain->created, ctx->domain->created);
+
+    mock_reply_json(ctx, strcmp(method, "PUT") ? 200 : 201, &body);
+} /* end mock_handle_domain() */
+
+/* Handles POST /groups, /datasets and /datatypes */
+static void
+mock_create_object(mock_ctx_t *ctx, mock_obj_type_t obj_type)
+{
+    rv_mock_hsds_t *server = ctx->server;
+    mock_object_t  *parent = NULL;
+    mock_object_t  *obj;
+    mock_shape_t    shape;
+    const char     *link_name = NULL;
+    mock_buf_t      body = { NULL, 0, 0, 0 };
+    yajl_val        link, type;
+    size_t          elem_size = 0;
+    char           *type_json = NULL;
+    char           *cprops_json = NULL;
+    char           *data = NULL;
+
+    if (NULL != (link = mock_json_get(ctx->body, "link"))) {
+        const char *parent_id = YAJL_GET_STRING(mock_json_get(link, "id"));
+
+        link_name = YAJL_GET_STRING(mock_json_get(link, "name"));
+        if (!parent_id || !link_name) {
+            mock_reply_error(ctx, 400, "invalid link in request body");
+            return;
+        } /* end if */
+
+        if (NULL == (parent = mock_find_object(server, ctx->domain, parent_id)) || parent->obj_type != MOCK_GROUP) {
+            mock_reply_error(ctx, 404, "parent group not found");
+            return;
+        } /* end if */
+
+        if (mock_find_link(parent, link_name)) {
+            mock_reply_error(ctx, 409, "link name already exists");
+            return;
+        } /* end if */
+    } /* end if */
+
+    if (obj_type != MOCK_GROUP) {
+        if (NULL == (type = mock_json_get(ctx->body, "type"))) {
+            mock_reply_error(ctx, 400, "missing datatype in request body");
+            return;
+        } /* end if */
+
+        /* Objects created with a committed datatype are given a copy of its description */
+        if (YAJL_IS_STRING(type) && !strncmp(type->u.string, "t-", 2)) {
+            mock_object_t *committed = mock_find_object(server, ctx->domain, type->u.string);
+
+            if (!committed || committed->obj_type != MOCK_DATATYPE) {
+                mock_reply_error(ctx, 404, "committed datatype not found");
+                return;
+            } /* end if */
+
+            type_json = mock_strdup(committed->type_json);
+            elem_size = committed->elem_size;
+        } /* end if */
+        else {
+            type_json = mock_json_to_string(type);
+            elem_size = mock_type_size(server, ctx->domain, type);
+        } /* end else */
+
+        if (!type_json)
+            goto oom;
+    } /* end if */
+
+    if (obj_type == MOCK_DATASET) {
+        yajl_val cprops;
+
+        if (mock_parse_shape(mock_json_get(ctx->body, "shape"), mock_json_get(ctx->body, "maxdims"), &shape) < 0) {
+            free(type_json);
+            mock_reply_error(ctx, 400, "invalid shape in request body");
+            return;
+        } /* end if */
+
+        if (NULL != (cprops = mock_json_get(ctx->body, "creationProperties")))
+            if (NULL == (cprops_json = mock_json_to_string(cprops)))
+                goto oom;
+
+        if (elem_size && mock_shape_nelmts(&shape))
+            if (NULL == (data = (char *) calloc((size_t) mock_shape_nelmts(&shape), elem_size)))
+                goto oom;
+    } /* end if */
+
+    if (NULL == (obj = mock_new_object(server, ctx->domain, obj_type)))
+        goto oom;
+
+    obj->type_json = type_json;
+    obj->elem_size = elem_size;
+    obj->cprops_json = cprops_json;
+    obj->data = data;
+    if (obj_type == MOCK_DATASET)
+        obj->shape = shape;
+
+    if (parent) {
+        mock_link_t *new_link;
+
+        if (NULL == (new_link = mock_add_link(parent, link_name))) {
+            mock_reply_error(ctx, 500, "out of memory");
+            return;
+        } /* end if */
+
+        new_link->link_class = MOCK_LINK_HARD;
+        strcpy(new_link->id, obj->id);
+    } /* end if */
+
+    mock_write_object(&body, obj);
+    mock_reply_json(ctx, 201, &body);
+
+    return;
+
+oom:
+    free(type_json);
+    free(cprops_json);
+    free(data);
+    mock_reply_error(ctx, 500, "out of memory");
+} /* end mock_create_object() */
+
+static void
+mock_handle_link(mock_ctx_t *ctx, mock_object_t *group, const char *name)
+{
+    rv_mock_hsds_t *server = ctx->server;
+    const char     *method = ctx->request->method;
+    mock_link_t    *link = mock_find_link(group, name);
+    mock_buf_t      body = { NULL, 0, 0, 0 };
+
+    if (!strcmp(method, "GET")) {
+        if (!link) {
+            mock_reply_error(ctx, 404, "link not found");
+            return;
+        } /* end if */
+
+        mock_buf_puts(&body, "{\"link\": ");
+        mock_write_link(&body, server, ctx->domain, link);
+        mock_buf_printf(&body, ", \"created\": %.3f, \"lastModified\": %.3f, ", link->created, link->created);
+        mock_write_hrefs(&body, group);
+        mock_buf_puts(&body, "}");
+
+        mock_reply_json(ctx, 200, &body);
+    } /* end if */
+    else if (!strcmp(method, "PUT")) {
+        const char *target_id = YAJL_GET_STRING(mock_json_get(ctx->body, "id"));
+        const char *h5path = YAJL_GET_STRING(mock_json_get(ctx->body, "h5path"));
+        const char *h5domain = YAJL_GET_STRING(mock_json_get(ctx->body, "h5domain"));
+
+        if (link) {
+            mock_reply_error(ctx, 409, "link name already exists");
+            return;
+        } /* end if */
+
+        if (!target_id && !h5path) {
+            mock_reply_error(ctx, 400, "invalid link in request body");
+            return;
+        } /* end if */
+
+        if (target_id && !mock_find_object(server, ctx->domain, target_id)) {
+            mock_reply_error(ctx, 404, "link target not found");
+            return;
+        } /* end if */
+
+        if (NULL == (link = mock_add_link(group, name))) {
+            mock_reply_error(ctx, 500, "out of memory");
+            return;
+        } /* end if */
+
+        if (target_id) {
+            link->link_class = MOCK_LINK_HARD;
+            snprintf(link->id, sizeof(link->id), "%s", target_id);
+        } /* end if */
+        else {
+            link->link_class = h5domain ? MOCK_LINK_EXTERNAL : MOCK_LINK_SOFT;
+            link->h5path = mock_strdup(h5path);
+            if (h5domain)
+                link->h5domain = mock_strdup(h5domain);
+        } /* end else */
+
+        mock_reply_empty(ctx, 201);
+    } /* end else if */
+    else if (!strcmp(method, "DELETE")) {
+        size_t idx;
+
+        if (!link) {
+            mock_reply_error(ctx, 404, "link not found");
+            return;
+        } /* end if */
+
+        idx = (size_t) (link - group->links);
+        mock_free_link(link);
+        memmove(&group->links[idx], &group->links[idx + 1], (group->nlinks - idx - 1) * sizeof(*link));
+        group->nlinks--;
+        group->last_modified = mock_now();
+
+        mock_reply_empty(ctx, 200);
+    } /* end else if */
+    else
+        mock_reply_error(ctx, 405, "method not allowed on link");
+} /* end mock_handle_link() */
+
+static void
+mock_handle_attribute(mock_ctx_t *ctx, mock_object_t *obj, const char *name, int is_value)
+{
+    rv_mock_hsds_t *server = ctx->server;
+    const char     *method = ctx->request->method;
+    mock_attr_t    *attr = mock_find_attr(obj, name);
+    mock_buf_t      body = { NULL, 0, 0, 0 };
+
+    if (!attr && strcmp(method, "PUT")) {
+        mock_reply_error(ctx, 404, "attribute not found");
+        return;
+    } /* end if */
+
+    if (is_value) {
+        size_t nbytes;
+
+        if (!attr) {
+            mock_reply_error(ctx, 404, "attribute not found");
+            return;
+        } /* end if */
+
+        if (!attr->elem_size) {
+            mock_reply_error(ctx, 501, "attribute datatype is not supported by the mock server");
+            return;
+        } /* end if */
+
+        nbytes = (size_t) mock_shape_nelmts(&attr->shape) * attr->elem_size;
+
+        if (!strcmp(method, "GET")) {
+            mock_buf_append(&body, attr->data ? attr->data : "", attr->data ? nbytes : 0);
+            mock_reply(ctx, 200, &body, "application/octet-stream");
+        } /* end if */
+        else if (!strcmp(method, "PUT")) {
+            if (ctx->request->body_len != nbytes) {
+                mock_reply_error(ctx, 400, "attribute write size does not match attribute size");
+                return;
+            } /* end if */
+
+            if (nbytes)
+                memcpy(attr->data, ctx->request->body, nbytes);
+            obj->last_modified = mock_now();
+
+            mock_reply_empty(ctx, 200);
+        } /* end else if */
+        else
+            mock_reply_error(ctx, 405, "method not allowed on attribute value");
+
+        return;
+    } /* end if */
+
+    if (!strcmp(method, "GET")) {
+        mock_write_attr(&body, attr);
+        mock_reply_json(ctx, 200, &body);
+    } /* end if */
+    else if (!strcmp(method, "PUT")) {
+        mock_shape_t shape;
+        yajl_val     type;
+
+        if (attr) {
+            mock_reply_error(ctx, 409, "attribute already exists");
+            return;
+        } /* end if */
+
+        if (NULL == (type = mock_json_get(ctx->body, "type"))
+                || mock_parse_shape(mock_json_get(ctx->body, "shape"), NULL, &shape) < 0) {
+            mock_reply_error(ctx, 400, "invalid attribute in request body");
+            return;
+        } /* end if */
+
+        if (obj->nattrs == obj->attrs_nalloc) {
+            size_t       new_nalloc = obj->attrs_nalloc ? obj->attrs_nalloc * 2 : 4;
+            mock_attr_t *tmp;
+
+            if (NULL == (tmp = (mock_attr_t *) realloc(obj->attrs, new_nalloc * sizeof(*tmp)))) {
+                mock_reply_error(ctx, 500, "out of memory");
+                return;
+            } /* end if */
+            obj->attrs = tmp;
+            obj->attrs_nalloc = new_nalloc;
+        } /* end if */
+
+        attr = &obj->attrs[obj->nattrs];
+        memset(attr, 0, sizeof(*attr));
+        attr->shape = shape;
+        attr->created = mock_now();
+        attr->elem_size = mock_type_size(server, ctx->domain, type);
+        attr->name = mock_strdup(name);
+
+        /* Attributes created with a committed datatype are given a copy of its description */
+        if (YAJL_IS_STRING(type) && !strncmp(type->u.string, "t-", 2)) {
+            mock_object_t *committed = mock_find_object(server, ctx->domain, type->u.string);
+
+            attr->type_json = committed ? mock_strdup(committed->type_json) : NULL;
+        } /* end if */
+        else
+            attr->type_json = mock_json_to_string(type);
+        if (attr->elem_size && mock_shape_nelmts(&shape))
+            attr->data = (char *) calloc((size_t) mock_shape_nelmts(&shape), attr->elem_size);
+
+        if (!attr->name || !attr->type_json || (attr->elem_size && mock_shape_nelmts(&shape) && !attr->data)) {
+            mock_free_attr(attr);
+            mock_reply_error(ctx, 500, "out of memory");
+            return;
+        } /* end if */
+
+        obj->nattrs++;
+        obj->last_modified = attr->created;
+
+        mock_reply_empty(ctx, 201);
+    } /* end else if */
+    else if (!strcmp(method, "DELETE")) {
+        size_t idx = (size_t) (attr - obj->attrs);
+
+        mock_free_attr(attr);
+        memmove(&obj->attrs[idx], &obj->attrs[idx + 1], (obj->nattrs - idx - 1) * sizeof(*attr));
+        obj->nattrs--;
+        obj->last_modified = mock_now();
+
+        mock_reply_empty(ctx, 200);
+    } /* end else if */
+    else
+        mock_reply_error(ctx, 405, "method not allowed on attribute");
+} /* end mock_handle_attribute() */
+
+static void
+mock_handle_value(mock_ctx_t *ctx, mock_object_t *dset)
+{
+    const rv_mock_hsds_request_t *request = ctx->request;
+    const char                   *method = request->method;
+    mock_buf_t                    body = { NULL, 0, 0, 0 };
+    uint64_t                      start[MOCK_MAX_DIMS], count[MOCK_MAX_DIMS], step[MOCK_MAX_DIMS];
+    uint64_t                     *offsets = NULL;
+    size_t                        npoints = 0;
+    size_t                        nbytes, i;
+    char                         *values = NULL;
+
+    if (mock_param(ctx, "query")) {
+        mock_reply_error(ctx, 501, "dataset queries are not supported by the mock server");
+        return;
+    } /* end if */
+
+    if (!dset->elem_size) {
+        mock_reply_error(ctx, 501, "dataset datatype is not supported by the mock server");
+        return;
+    } /* end if */
+
+    /* Point selections are sent as JSON, either POSTed for reads or PUT
+     * along with base64-encoded data for writes
+     */
+    if (ctx->body && (!strcmp(method, "POST") || !strcmp(method, "PUT"))) {
+        if (mock_parse_points(mock_json_get(ctx->body, "points"), &dset->shape, &offsets, &npoints) < 0) {
+            mock_reply_error(ctx, 400, "invalid point selection");
+            return;
+        } /* end if */
+
+        nbytes = npoints * dset->elem_size;
+
+        if (!strcmp(method, "POST")) {
+            if (mock_buf_reserve(&body, nbytes) == 0) {
+                for (i = 0; i < npoints; i++)
+                    memcpy(body.data + i * dset->elem_size, dset->data + offsets[i] * dset->elem_size, dset->elem_size);
+                body.len = nbytes;
+            } /* end if */
+
+            mock_reply(ctx, 200, &body, "application/octet-stream");
+        } /* end if */
+        else {
+            const char *encoded = YAJL_GET_STRING(mock_json_get(ctx->body, "value_base64"));
+            size_t      values_len;
+
+            if (!encoded || mock_base64_decode(encoded, &values, &values_len) < 0 || values_len != nbytes) {
+                mock_reply_error(ctx, 400, "invalid point selection write data");
+            } /* end if */
+            else {
+                for (i = 0; i < npoints; i++)
+                    memcpy(dset->data + offsets[i] * dset->elem_size, values + i * dset->elem_size, dset->elem_size);
+                dset->last_modified = mock_now();
+
+                mock_reply_empty(ctx, 200);
+            } /* end else */
+        } /* end else */
+
+        free(values);
+        free(offsets);
+
+        return;
+    } /* end if */
+
+    if (mock_parse_select(mock_param(ctx, "select"), &dset->shape, start, count, step) < 0) {
+        mock_reply_error(ctx, 400, "invalid selection");
+        return;
+    } /* end if */
+
+    if (dset->shape.space_class == MOCK_SPACE_NULL)
+        nbytes = 0;
+    else
+        for (i = 0, nbytes = dset->elem_size; i < (size_t) dset->shape.ndims; i++)
+            nbytes *= (size_t) count[i];
+
+    if (!strcmp(method, "GET")) {
+        const char *content_encoding = NULL;
+
+        if (mock_buf_reserve(&body, nbytes) == 0) {
+            if (nbytes)
+                mock_copy_selection(dset->data, &dset->shape, dset->elem_size, start, count, step, body.data, 0);
+            body.len = nbytes;
+        } /* end if */
+
+        mock_encode_value(&ctx->server->config, request->accept_encoding, dset->elem_size, &body, &content_encoding);
+
+        mock_reply(ctx, 200, &body, "application/octet-stream");
+        ctx->response->content_encoding = content_encoding;
+    } /* end if */
+    else if (!strcmp(method, "PUT")) {
+        const char *value = request->body;
+
+        if (request->content_encoding) {
+            if (mock_decode_value(request->content_encoding, request->body, request->body_len, dset->elem_size,
+                    nbytes, &values) < 0) {
+                mock_reply_error(ctx, 415, "unsupported or corrupt content encoding");
+                return;
+            } /* end if */
+            value = values;
+        } /* end if */
+        else if (request->body_len != nbytes) {
+            mock_reply_error(ctx, 400, "write size does not match selection size");
+            return;
+        } /* end if */
+
+        if (nbytes)
+            mock_copy_selection(dset->data, &dset->shape, dset->elem_size, start, count, step, (char *) value, 1);
+        dset->last_modified = mock_now();
+
+        free(values);
+
+        mock_reply_empty(ctx, 200);
+    } /* end else if */
+    else
+        mock_reply_error(ctx, 405, "method not allowed on dataset value");
+} /* end mock_handle_value() */
+
+static void
+mock_handle_shape(mock_ctx_t *ctx, mock_object_t *dset)
+{
+    const char *method = ctx->request->method;
+    mock_buf_t  body = { NULL, 0, 0, 0 };
+
+    if (!strcmp(method, "GET")) {
+        mock_buf_puts(&body, "{\"shape\": ");
+        mock_write_shape(&body, &dset->shape);
+        mock_buf_printf(&body, ", \"created\": %.3f, \"lastModified\": %.3f, ", dset->created, dset->last_modified);
+        mock_write_hrefs(&body, dset);
+        mock_buf_puts(&body, "}");
+
+        mock_reply_json(ctx, 200, &body);
+    } /* end if */
+    else if (!strcmp(method, "PUT")) {
+        mock_shape_t new_shape;
+        uint64_t     start[MOCK_MAX_DIMS], count[MOCK_MAX_DIMS], step[MOCK_MAX_DIMS];
+        uint64_t     nelmts;
+        char        *new_data = NULL;
+        char        *packed = NULL;
+        int          i;
+
+        if (mock_parse_shape(mock_json_get(ctx->body, "shape"), NULL, &new_shape) < 0
+                || new_shape.space_class != MOCK_SPACE_SIMPLE || dset->shape.space_class != MOCK_SPACE_SIMPLE
+                || new_shape.ndims != dset->shape.ndims) {
+            mock_reply_error(ctx, 400, "invalid shape in request body");
+            return;
+        } /* end if */
+
+        for (i = 0, nelmts = 1; i < new_shape.ndims; i++) {
+            uint64_t maxdim = dset->shape.has_maxdims ? dset->shape.maxdims[i] : dset->shape.dims[i];
+
+            if (maxdim && new_shape.dims[i] > maxdim) {
+                mock_reply_error(ctx, 400, "shape exceeds maximum dimensions");
+                return;
+            } /* end if */
+
+            start[i] = 0;
+            count[i] = new_shape.dims[i] < dset->shape.dims[i] ? new_shape.dims[i] : dset->shape.dims[i];
+            step[i] = 1;
+            nelmts *= count[i];
+        } /* end for */
+
+        new_shape.has_maxdims = dset->shape.has_maxdims;
+        memcpy(new_shape.maxdims, dset->shape.maxdims, sizeof(new_shape.maxdims));
+
+        /* Carry the overlapping region of the old extent over to the new one */
+        if (dset->elem_size) {
+            if (mock_shape_nelmts(&new_shape)
+                    && NULL == (new_data = (char *) calloc((size_t) mock_shape_nelmts(&new_shape), dset->elem_size))) {
+                mock_reply_error(ctx, 500, "out of memory");
+                return;
+            } /* end if */
+
+            if (nelmts) {
+                if (NULL == (packed = (char *) malloc((size_t) nelmts * dset->elem_size))) {
+                    free(new_data);
+                    mock_reply_error(ctx, 500, "out of memory");
+                    return;
+                } /* end if */
+
+                mock_copy_selection(dset->data, &dset->shape, dset->elem_size, start, count, step, packed, 0);
+                mock_copy_selection(new_data, &new_shape, dset->elem_size, start, count, step, packed, 1);
+                free(packed);
+            } /* end if */
+
+            free(dset->data);
+            dset->data = new_data;
+        } /* end if */
+
+        dset->shape = new_shape;
+        dset->last_modified = mock_now();
+
+        mock_reply_empty(ctx, 201);
+    } /* end else if */
+    else
+        mock_reply_error(ctx, 405, "method not allowed on dataset shape");
+} /* end mock_handle_shape() */
+
+/* Handles every request under /groups, /datasets and /datatypes */
+static void
+mock_handle_collection(mock_ctx_t *ctx, mock_obj_type_t obj_type)
+{
+    rv_mock_hsds_t *server = ctx->server;
+    const char     *method = ctx->request->method;
+    const char     *h5path = mock_param(ctx, "h5path");
+    const char     *sub = ctx->nsegs > 2 ? ctx->segs[2] : NULL;
+    mock_object_t  *obj = NULL;
+    mock_buf_t      body = { NULL, 0, 0, 0 };
+    size_t          i;
+
+    if (!ctx->domain) {
+        mock_reply_error(ctx, 404, "domain not found");
+        return;
+    } /* end if */
+
+    if (ctx->nsegs == 1) {
+        if (!strcmp(method, "POST"))
+            mock_create_object(ctx, obj_type);
+        else
+            mock_reply_error(ctx, 405, "method not allowed on collection");
+        return;
+    } /* end if */
+
+    /* Objects are addressed by ID, by a path relative to the object given
+     * by ID or "grpid", or by an absolute path
+     */
+    if (!*ctx->segs[1]) {
+        const char    *grpid = mock_param(ctx, "grpid");
+        mock_object_t *start = NULL;
+
+        if (!h5path) {
+            mock_reply_error(ctx, 400, "missing object ID or h5path");
+            return;
+        } /* end if */
+
+        if (grpid && NULL == (start = mock_find_object(server, ctx->domain, grpid))) {
+            mock_reply_error(ctx, 404, "group not found");
+            return;
+        } /* end if */
+
+        obj = mock_resolve_path(server, ctx->domain, start, h5path, 0);
+    } /* end if */
+    else {
+        obj = mock_find_object(server, ctx->domain, ctx->segs[1]);
+        if (obj && h5path)
+            obj = mock_resolve_path(server, ctx->domain, obj, h5path, 0);
+    } /* end else */
+
+    if (!obj || obj->obj_type != obj_type) {
+        mock_reply_error(ctx, 404, "object not found");
+        return;
+    } /* end if */
+
+    if (!sub) {
+        if (!strcmp(method, "GET")) {
+            mock_write_object(&body, obj);
+            mock_reply_json(ctx, 200, &body);
+        } /* end if */
+        else if (!strcmp(method, "DELETE")) {
+            if (!strcmp(obj->id, ctx->domain->root_id)) {
+                mock_reply_error(ctx, 403, "the root group can't be deleted");
+                return;
+            } /* end if */
+
+            mock_remove_objects(server, mock_match_object, obj);
+            mock_reply_empty(ctx, 200);
+        } /* end else if */
+        else
+            mock_reply_error(ctx, 405, "method not allowed on object");
+    } /* end if */
+    else if (!strcmp(sub, "links") && obj_type == MOCK_GROUP) {
+        if (ctx->nsegs == 4) {
+            mock_handle_link(ctx, obj, ctx->segs[3]);
+            return;
+        } /* end if */
+
+        mock_buf_puts(&body, "{\"links\": [");
+        for (i = 0; i < obj->nlinks; i++) {
+            if (i > 0) mock_buf_puts(&body, ", ");
+            mock_write_link(&body, server, ctx->domain, &obj->links[i]);
+        } /* end for */
+        mock_buf_puts(&body, "], ");
+        mock_write_hrefs(&body, obj);
+        mock_buf_puts(&body, "}");
+
+        mock_reply_json(ctx, 200, &body);
+    } /* end else if */
+    else if (!strcmp(sub, "attributes")) {
+        if (ctx->nsegs >= 4) {
+            mock_handle_attribute(ctx, obj, ctx->segs[3], ctx->nsegs == 5 && !strcmp(ctx->segs[4], "value"));
+            return;
+        } /* end if */
+
+        mock_buf_puts(&body, "{\"attributes\": [");
+        for (i = 0; i < obj->nattrs; i++) {
+            if (i > 0) mock_buf_puts(&body, ", ");
+            mock_write_attr(&body, &obj->attrs[i]);
+        } /* end for */
+        mock_buf_puts(&body, "], ");
+        mock_write_hrefs(&body, obj);
+        mock_buf_puts(&body, "}");
+
+        mock_reply_json(ctx, 200, &body);
+    } /* end else if */
+    else if (!strcmp(sub, "value") && obj_type == MOCK_DATASET)
+        mock_handle_value(ctx, obj);
+    else if (!strcmp(sub, "shape") && obj_type == MOCK_DATASET)
+        mock_handle_shape(ctx, obj);
+    else if (!strcmp(sub, "type") && obj_type == MOCK_DATASET) {
+        mock_buf_printf(&body, "{\"type\": %s, ", obj->type_json);
+        mock_write_hrefs(&body, obj);
+        mock_buf_puts(&body, "}");
+
+        mock_reply_json(ctx, 200, &body);
+    } /* end else if */
+    else
+        mock_reply_error(ctx, 404, "unknown resource");
+} /* end mock_handle_collection() */
+
+/* Splits the request target into decoded path segments and query parameters */
+static int
+mock_parse_target(mock_ctx_t *ctx)
+{
+    const char *path = ctx->request->path;
+    const char *query = ctx->request->query;
+
+    while (*path == '/')
+        path++;
+
+    while (*path) {
+        const char *end = strchr(path, '/');
+        size_t      len = end ? (size_t) (end - path) : strlen(path);
+
+        if (ctx->nsegs == MOCK_MAX_SEGMENTS)
+            return -1;
+        if (NULL == (ctx->segs[ctx->nsegs++] = mock_url_decode(path, len)))
+            return -1;
+
+        if (!end)
+            break;
+
+        path = end + 1;
+
+        /* Keep a trailing empty segment, as in "/datasets/?h5path=..." */
+        if (!*path) {
+            if (ctx->nsegs == MOCK_MAX_SEGMENTS || NULL == (ctx->segs[ctx->nsegs++] = mock_strdup("")))
+                return -1;
+        } /* end if */
+    } /* end while */
+
+    while (query && *query) {
+        const char *end = strchr(query, '&');
+        const char *eq;
+        size_t      len = end ? (size_t) (end - query) : strlen(query);
+
+        if (ctx->nparams == MOCK_MAX_PARAMS)
+            return -1;
+
+        eq = memchr(query, '=', len);
+        ctx->params[ctx->nparams].key = mock_url_decode(query, eq ? (size_t) (eq - query) : len);
+        ctx->params[ctx->nparams].value = eq ? mock_url_decode(eq + 1, len - (size_t) (eq - query) - 1) : mock_strdup("");
+        if (!ctx->params[ctx->nparams].key || !ctx->params[ctx->nparams].value) {
+            free(ctx->params[ctx->nparams].key);
+            free(ctx->params[ctx->nparams].value);
+            return -1;
+        } /* end if */
+        ctx->nparams++;
+
+        query = end ? end + 1 : query + len;
+    } /* end while */
+
+    return 0;
+} /* end mock_parse_target() */
+
+int
+rv_mock_hsds_handle_request(rv_mock_hsds_t *server, const rv_mock_hsds_request_t *request,
+                            rv_mock_hsds_response_t *response)
+{
+    mock_ctx_t  ctx;
+    const char *domain_name;
+    size_t      i;
+    int         ret_value = 0;
+
+    if (!server || !request || !request->method || !request->path || !response)
+        return -1;
+
+    memset(&ctx, 0, sizeof(ctx));
+    memset(response, 0, sizeof(*response));
+    ctx.server = server;
+    ctx.request = request;
+    ctx.response = response;
+
+    if (mock_parse_target(&ctx) < 0) {
+        mock_reply_error(&ctx, 400, "malformed request target");
+        goto done;
+    } /* end if */
+
+    /* Only JSON request bodies are parsed; dataset and attribute values are binary */
+    if (request->body_len && ((request->content_type && strstr(request->content_type, "json"))
+            || (!request->content_type && request->body[0] == '{'))) {
+        char *json;
+        char  err[256];
+
+        if (NULL == (json = (char *) malloc(request->body_len + 1))) {
+            mock_reply_error(&ctx, 500, "out of memory");
+            goto done;
+        } /* end if */
+        memcpy(json, request->body, request->body_len);
+        json[request->body_len] = '\0';
+
+        ctx.body = yajl_tree_parse(json, err, sizeof(err));
+        free(json);
+
+        if (!ctx.body) {
+            mock_reply_error(&ctx, 400, "malformed JSON in request body");
+            goto done;
+        } /* end if */
+    } /* end if */
+
+    domain_name = request->domain ? request->domain : mock_param(&ctx, "domain");
+
+    pthread_mutex_lock(&server->lock);
+
+    server->stats.num_requests++;
+    server->stats.bytes_received += request->body_len;
+
+    ctx.domain = domain_name ? mock_find_domain(server, domain_name) : NULL;
+
+    if (!domain_name)
+        mock_reply_error(&ctx, 400, "no domain given");
+    else if (!ctx.nsegs)
+        mock_handle_domain(&ctx, domain_name);
+    else if (!strcmp(ctx.segs[0], "groups"))
+        mock_handle_collection(&ctx, MOCK_GROUP);
+    else if (!strcmp(ctx.segs[0], "datasets"))
+        mock_handle_collection(&ctx, MOCK_DATASET);
+    else if (!strcmp(ctx.segs[0], "datatypes"))
+        mock_handle_collection(&ctx, MOCK_DATATYPE);
+    else
+        mock_reply_error(&ctx, 404, "unknown resource");
+
+    server->stats.bytes_sent += response->body_len;
+
+    pthread_mutex_unlock(&server->lock);
+
+done:
+    if (server->config.verbose)
+        fprintf(stderr, "mock HSDS: %s %s%s%s (%s) -> %d, %zu bytes\n", request->method, request->path,
+                request->query ? "?" : "", request->query ? request->query : "",
+                request->domain ? request->domain : "no domain", response->status, response->body_len);
+
+    if (response->status == 500 && !response->body)
+        ret_value = -1;
+
+    for (i = 0; i < ctx.nsegs; i++)
+        free(ctx.segs[i]);
+    for (i = 0; i < ctx.nparams; i++) {
+        free(ctx.params[i].key);
+        free(ctx.params[i].value);
+    } /* end for */
+    if (ctx.body)
+        yajl_tree_free(ctx.body);
+
+    return ret_value;
+} /* end rv_mock_hsds_handle_request() */
+
+void
+rv_mock_hsds_free_response(rv_mock_hsds_response_t *response)
+{
+    if (!response)
+        return;
+
+    free(response->body);
+    response->body = NULL;
+    response->body_len = 0;
+} /* end rv_mock_hsds_free_response() */
+
+int
+rv_mock_hsds_get_stats(rv_mock_hsds_t *server, rv_mock_hsds_stats_t *stats)
+{
+    if (!server || !stats)
+        return -1;
+
+    pthread_mutex_lock(&server->lock);
+    *stats = server->stats;
+    pthread_mutex_unlock(&server->lock);
+
+    pthread_mutex_lock(&server->conn_lock);
+    stats->num_open_connections = (uint64_t) server->nconns;
+    pthread_mutex_unlock(&server->conn_lock);
+
+    return 0;
+} /* end rv_mock_hsds_get_stats() */
+
+int
+rv_mock_hsds_get_port_stats(rv_mock_hsds_t *server, unsigned short port, rv_mock_hsds_stats_t *stats)
+{
+    size_t i;
+    int    ret_value = -1;
+
+    if (!server || !stats)
+        return -1;
+
+    pthread_mutex_lock(&server->lock);
+    for (i = 0; i < server->nlisteners; i++)
+        if (server->listeners[i].port == port) {
+            *stats = server->listeners[i].stats;
+            ret_value = 0;
+            break;
+        } /* end if */
+    pthread_mutex_unlock(&server->lock);
+
+    return ret_value;
+} /* end rv_mock_hsds_get_port_stats() */
+
+int
+rv_mock_hsds_set_faults(rv_mock_hsds_t *server, unsigned short port, const rv_mock_hsds_faults_t *faults)
+{
+    size_t i;
+    int    ret_value = -1;
+
+    if (!server || !faults)
+        return -1;
+
+    pthread_mutex_lock(&server->lock);
+    for (i = 0; i < server->nlisteners; i++)
+        if (!port || server->listeners[i].port == port) {
+            server->listeners[i].faults = *faults;
+            ret_value = 0;
+        } /* end if */
+    pthread_mutex_unlock(&server->lock);
+
+    return ret_value;
+} /* end rv_mock_hsds_set_faults() */
+
+rv_mock_hsds_t *
+rv_mock_hsds_create(const rv_mock_hsds_config_t *config)
+{
+    rv_mock_hsds_t *server;
+
+    if (NULL == (server = (rv_mock_hsds_t *) calloc(1, sizeof(*server))))
+        return NULL;
+
+    if (config)
+        server->config = *config;
+
+    server->nbuckets = MOCK_INITIAL_NBUCKETS;
+    if (NULL == (server->buckets = (mock_object_t **) calloc(server->nbuckets, sizeof(*server->buckets)))) {
+        free(server);
+        return NULL;
+    } /* end if */
+
+    pthread_mutex_init(&server->lock, NULL);
+    pthread_mutex_init(&server->conn_lock, NULL);
+    pthread_cond_init(&server->conn_cond, NULL);
+
+    return server;
+} /* end rv_mock_hsds_create() */
+
+int
+rv_mock_hsds_destroy(rv_mock_hsds_t *server)
+{
+    if (!server)
+        return -1;
+
+    if (server->running && rv_mock_hsds_stop(server) < 0)
+        return -1;
+
+    mock_remove_objects(server, mock_match_all, NULL);
+    while (server->domains) {
+        mock_domain_t *next = server->domains->next;
+
+        free(server->domains->name);
+        free(server->domains);
+        server->domains = next;
+    } /* end while */
+
+    free(server->buckets);
+    free(server->conn_fds);
+    pthread_mutex_destroy(&server->lock);
+    pthread_mutex_destroy(&server->conn_lock);
+    pthread_cond_destroy(&server->conn_cond);
+    free(server);
+
+    return 0;
+} /* end rv_mock_hsds_destroy() */
+
+
+/*-------------------------------------------------------------------------
+ *                           HTTP/1.1 socket layer
+ *-------------------------------------------------------------------------
+ */
+
+static const char *
+mock_status_text(int status)
+{
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 415: return "Unsupported Media Type";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return status >= 500 ? "Internal Server Error" : "Unknown";
+    } /* end switch */
+} /* end mock_status_text() */
+
+static void
+mock_sleep_us(uint64_t usec)
+{
+    struct timespec ts;
+
+    if (!usec)
+        return;
+
+    ts.tv_sec = (time_t) (usec / 1000000);
+    ts.tv_nsec = (long) ((usec % 1000000) * 1000);
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR)
+        ;
+} /* end mock_sleep_us() */
+
+static int
+mock_send_all(int fd, const char *data, size_t len)
+{
+    while (len) {
+        ssize_t nsent = send(fd, data, len, MSG_NOSIGNAL);
+
+        if (nsent < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        } /* end if */
+
+        data += nsent;
+        len -= (size_t) nsent;
+    } /* end while */
+
+    return 0;
+} /* end mock_send_all() */
+
+/* Reads more data from the connection into the buffer. Returns the number
+ * of bytes read, 0 on EOF and negative on error.
+ */
+static ssize_t
+mock_recv_more(int fd, mock_buf_t *in)
+{
+    ssize_t nread;
+
+    if (mock_buf_reserve(in, MOCK_RECV_SIZE) < 0)
+        return -1;
+
+    do {
+        nread = recv(fd, in->data + in->len, MOCK_RECV_SIZE, 0);
+    } while (nread < 0 && errno == EINTR);
+
+    if (nread > 0) {
+        in->len += (size_t) nread;
+        in->data[in->len] = '\0';
+    } /* end if */
+
+    return nread;
+} /* end mock_recv_more() */
+
+/* Returns a pointer to the value of the last occurrence of the named header
+ * and its length, searching only within the header block
+ */
+static const char *
+mock_find_header(const char *headers, const char *headers_end, const char *name, size_t *value_len)
+{
+    const char *line = headers;
+    const char *found = NULL;
+    size_t      name_len = strlen(name);
+
+    while (line < headers_end) {
+        const char *eol = strstr(line, "\r\n");
+
+        if (!eol || eol > headers_end)
+            eol = headers_end;
+
+        if ((size_t) (eol - line) > name_len && line[name_len] == ':' && !strncasecmp(line, name, name_len)) {
+            const char *value = line + name_len + 1;
+
+            while (value < eol && (*value == ' ' || *value == '\t'))
+                value++;
+            found = value;
+            *value_len = (size_t) (eol - value);
+        } /* end if */
+
+        line = eol + 2;
+    } /* end while */
+
+    return found;
+} /* end mock_find_header() */
+
+static void
+mock_remove_connection(rv_mock_hsds_t *server, int fd)
+{
+    size_t i;
+
+    pthread_mutex_lock(&server->conn_lock);
+    for (i = 0; i < server->nconns; i++)
+        if (server->conn_fds[i] == fd) {
+            server->conn_fds[i] = server->conn_fds[--server->nconns];
+            break;
+        } /* end if */
+    pthread_cond_broadcast(&server->conn_cond);
+    pthread_mutex_unlock(&server->conn_lock);
+} /* end mock_remove_connection() */
+
+/* Serves HTTP/1.1 requests on one keep-alive connection */
+/* Account for a request that a connection has started or finished handling,
+ * with the server's lock held
+ */
+static void
+mock_begin_request(rv_mock_hsds_t *server, mock_listener_t *listener)
+{
+    if (++server->requests_in_flight > server->stats.max_requests_in_flight)
+        server->stats.max_requests_in_flight = server->requests_in_flight;
+    if (++listener->requests_in_flight > listener->stats.max_requests_in_flight)
+        listener->stats.max_requests_in_flight = listener->requests_in_flight;
+} /* end mock_begin_request() */
+
+static void
+mock_end_request(rv_mock_hsds_t *server, mock_listener_t *listener)
+{
+    server->requests_in_flight--;
+    listener->requests_in_flight--;
+} /* end mock_end_request() */
+
+static void *
+mock_connection_thread(void *arg)
+{
+    mock_conn_args_t *args = (mock_conn_args_t *) arg;
+    mock_listener_t  *listener = args->listener;
+    rv_mock_hsds_t   *server = listener->server;
+    mock_buf_t        in = { NULL, 0, 0, 0 };
+    mock_buf_t        chunked = { NULL, 0, 0, 0 };
+    mock_buf_t        header = { NULL, 0, 0, 0 };
+    int               fd = args->fd;
+
+    free(args);
+
+    for (;;) {
+        rv_mock_hsds_request_t  request;
+        rv_mock_hsds_response_t response;
+        const char             *value;
+        char                   *header_end, *target, *version, *query;
+        char                   *domain = NULL, *content_type = NULL;
+        char                   *content_encoding = NULL, *accept_encoding = NULL;
+        const char             *fault_encoding = NULL;
+        size_t                  value_len, domain_len = 0, content_type_len = 0;
+        size_t                  content_encoding_len = 0, accept_encoding_len = 0;
+        size_t                  header_len, body_len = 0, consumed, target_offset;
+        size_t                  fault_truncate_len;
+        uint64_t                delay_us, fault_delay_us;
+        int                     keep_alive = 1;
+        int                     is_chunked = 0;
+        int                     fail_status = 0;
+        int                     unauthorized = 0;
+
+        /* Read the request line and headers */
+        while (NULL == (header_end = in.data ? strstr(in.data, "\r\n\r\n") : NULL)) {
+            if (in.len > MOCK_MAX_HEADER_SIZE || mock_recv_more(fd, &in) <= 0)
+                goto done;
+        } /* end while */
+
+        header_len = (size_t) (header_end - in.data) + 4;
+        *header_end = '\0';
+
+        memset(&request, 0, sizeof(request));
+        request.method = in.data;
+        if (NULL == (target = strchr(in.data, ' ')))
+            goto done;
+        *target++ = '\0';
+        if (NULL == (version = strchr(target, ' ')))
+            goto done;
+        *version++ = '\0';
+
+        {
+            char *eol = strstr(version, "\r\n");
+
+            if (eol)
+                *eol = '\0';
+            header.len = 0;
+            mock_buf_append(&header, eol ? eol + 2 : "", eol ? (size_t) (header_end - (eol + 2)) : 0);
+            if (header.failed)
+                goto done;
+        }
+
+        if (!strcmp(version, "HTTP/1.0"))
+            keep_alive = 0;
+
+        if ((value = mock_find_header(header.data, header.data + header.len, "Connection", &value_len)))
+            keep_alive = strncasecmp(value, "close", 5) != 0 && (keep_alive || !strncasecmp(value, "keep-alive", 10));
+        if ((value = mock_find_header(header.data, header.data + header.len, "Transfer-Encoding", &value_len)))
+            is_chunked = !strncasecmp(value, "chunked", 7);
+        if ((value = mock_find_header(header.data, header.data + header.len, "Content-Length", &value_len)))
+            body_len = (size_t) strtoull(value, NULL, 10);
+        if ((value = mock_find_header(header.data, header.data + header.len, "Expect", &value_len))
+                && value_len >= 12 && !strncasecmp(value, "100-continue", 12))
+            if (mock_send_all(fd, "HTTP/1.1 100 Continue\r\n\r\n", 25) < 0)
+                goto done;
+        if (server->config.authorization) {
+            value = mock_find_header(header.data, header.data + header.len, "Authorization", &value_len);
+            unauthorized = !value || value_len != strlen(server->config.authorization)
+                    || strncmp(value, server->config.authorization, value_len);
+        } /* end if */
+
+        /* The header values handed to the request handler are terminated in
+         * place, so they are located only after all other lookups are done
+         */
+        domain = (char *) mock_find_header(header.data, header.data + header.len, "X-Hdf-domain", &domain_len);
+        content_type = (char *) mock_find_header(header.data, header.data + header.len, "Content-Type", &content_type_len);
+        content_encoding = (char *) mock_find_header(header.data, header.data + header.len, "Content-Encoding",
+                &content_encoding_len);
+        accept_encoding = (char *) mock_find_header(header.data, header.data + header.len, "Accept-Encoding",
+                &accept_encoding_len);
+        if (domain)
+            domain[domain_len] = '\0';
+        if (content_type)
+            content_type[content_type_len] = '\0';
+        if (content_encoding)
+            content_encoding[content_encoding_len] = '\0';
+        if (accept_encoding)
+            accept_encoding[accept_encoding_len] = '\0';
+
+        /* Reading the body may move the connection's buffer, so remember where
+         * the request target is within it rather than keeping a pointer
+         */
+        target_offset = (size_t) (target - in.data);
+
+        /* Read the request body */
+        if (is_chunked) {
+            size_t pos = header_len;
+
+            chunked.len = 0;
+            for (;;) {
+                char   *eol;
+                size_t  chunk_size;
+
+                while (NULL == (eol = strstr(in.data + pos, "\r\n")))
+                    if (mock_recv_more(fd, &in) <= 0)
+                        goto done;
+
+                chunk_size = (size_t) strtoull(in.data + pos, NULL, 16);
+                pos = (size_t) (eol - in.data) + 2;
+
+                if (!chunk_size) {
+                    /* Skip any trailers up to the final empty line */
+                    for (;;) {
+                        while (NULL == (eol = strstr(in.data + pos, "\r\n")))
+                            if (mock_recv_more(fd, &in) <= 0)
+                                goto done;
+                        if ((size_t) (eol - in.data) == pos) {
+                            pos += 2;
+                            break;
+                        } /* end if */
+                        pos = (size_t) (eol - in.data) + 2;
+                    } /* end for */
+                    break;
+                } /* end if */
+
+                while (in.len < pos + chunk_size + 2)
+                    if (mock_recv_more(fd, &in) <= 0)
+                        goto done;
+
+                mock_buf_append(&chunked, in.data + pos, chunk_size);
+                if (chunked.failed)
+                    goto done;
+                pos += chunk_size + 2;
+            } /* end for */
+
+            request.body = chunked.data;
+            request.body_len = chunked.len;
+            consumed = pos;
+        } /* end if */
+        else {
+            while (in.len < header_len + body_len)
+                if (mock_recv_more(fd, &in) <= 0)
+                    goto done;
+
+            request.body = in.data + header_len;
+            request.body_len = body_len;
+            consumed = header_len + body_len;
+        } /* end else */
+
+        request.method = in.data;
+        target = in.data + target_offset;
+
+        if ((query = strchr(target, '?')))
+            *query++ = '\0';
+
+        /* Requests may use an absolute target */
+        if (!strncmp(target, "http://", 7) && (target = strchr(target + 7, '/')) == NULL)
+            target = (char *) "/";
+
+        request.path = target;
+        request.query = query;
+        request.domain = domain;
+        request.content_type = content_type;
+        request.content_encoding = content_encoding;
+        request.accept_encoding = accept_encoding;
+
+        /* Fail the request without handling it if the port has been told to */
+        pthread_mutex_lock(&server->lock);
+        listener->stats.num_requests++;
+        listener->stats.bytes_received += request.body_len;
+        mock_begin_request(server, listener);
+        if (listener->faults.fail_count) {
+            listener->faults.fail_count--;
+            fail_status = listener->faults.fail_status ? listener->faults.fail_status : 503;
+        } /* end if */
+        fault_encoding = listener->faults.content_encoding;
+        fault_delay_us = listener->faults.delay_us;
+        fault_truncate_len = listener->faults.truncate_len;
+        pthread_mutex_unlock(&server->lock);
+
+        if (fail_status) {
+            memset(&response, 0, sizeof(response));
+            response.status = fail_status;
+
+            if (server->config.verbose)
+                fprintf(stderr, "mock HSDS: %s %s -> %d (injected fault)\n", request.method, request.path, fail_status);
+        } /* end if */
+        else if (unauthorized) {
+            memset(&response, 0, sizeof(response));
+            response.status = 401;
+
+            if (server->config.verbose)
+                fprintf(stderr, "mock HSDS: %s %s -> 401 (bad credentials)\n", request.method, request.path);
+        } /* end else if */
+        else if (rv_mock_hsds_handle_request(server, &request, &response) < 0 && !response.status) {
+            pthread_mutex_lock(&server->lock);
+            mock_end_request(server, listener);
+            pthread_mutex_unlock(&server->lock);
+            goto done;
+        } /* end else if */
+
+        if (fault_encoding)
+            response.content_encoding = fault_encoding;
+        if (fault_truncate_len && response.content_type && !strcmp(response.content_type, "application/octet-stream"))
+            response.body_len = response.body_len > fault_truncate_len ? response.body_len - fault_truncate_len : 0;
+
+        pthread_mutex_lock(&server->lock);
+        listener->stats.bytes_sent += response.body_len;
+        pthread_mutex_unlock(&server->lock);
+
+        /* Emulate the network: a fixed latency plus the time to move both bodies */
+        delay_us = server->config.latency_us + fault_delay_us;
+        if (server->config.bandwidth_bytes_per_sec)
+            delay_us += (uint64_t) (((double) (request.body_len + response.body_len) * 1e6)
+                                    / (double) server->config.bandwidth_bytes_per_sec);
+        mock_sleep_us(delay_us);
+
+        pthread_mutex_lock(&server->lock);
+        mock_end_request(server, listener);
+        pthread_mutex_unlock(&server->lock);
+
+        header.len = 0;
+        mock_buf_printf(&header, "HTTP/1.1 %d %s\r\n"
+                                 "Content-Type: %s\r\n"
+                                 "Content-Length: %zu\r\n"
+                                 "Connection: %s\r\n",
+                        response.status, mock_status_text(response.status),
+                        response.content_type ? response.content_type : "application/json",
+                        response.body_len, keep_alive ? "keep-alive" : "close");
+        if (response.content_encoding)
+            mock_buf_printf(&header, "Content-Encoding: %s\r\n", response.content_encoding);
+        mock_buf_puts(&header, "\r\n");
+
+        if (header.failed || mock_send_all(fd, header.data, header.len) < 0
+                || (response.body_len && mock_send_all(fd, response.body, response.body_len) < 0)) {
+            rv_mock_hsds_free_response(&response);
+            goto done;
+        } /* end if */
+
+        rv_mock_hsds_free_response(&response);
+
+        /* Keep any pipelined data that followed this request */
+        mock_buf_consume(&in, consumed);
+
+        if (!keep_alive)
+            break;
+    } /* end for */
+
+done:
+    free(in.data);
+    free(chunked.data);
+    free(header.data);
+
+    mock_remove_connection(server, fd);
+    close(fd);
+
+    return NULL;
+} /* end mock_connection_thread() */
+
+static void *
+mock_accept_thread(void *arg)
+{
+    mock_listener_t *listener = (mock_listener_t *) arg;
+    rv_mock_hsds_t  *server = listener->server;
+
+    while (server->running) {
+        mock_conn_args_t *args;
+        pthread_attr_t    attr;
+        pthread_t         thread;
+        int               fd, one = 1;
+
+        if ((fd = accept(listener->fd, NULL, NULL)) < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            break;
+        } /* end if */
+
+        if (!server->running) {
+            close(fd);
+            break;
+        } /* end if */
+
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        if (NULL == (args = (mock_conn_args_t *) malloc(sizeof(*args)))) {
+            close(fd);
+            continue;
+        } /* end if */
+        args->listener = listener;
+        args->fd = fd;
+
+        pthread_mutex_lock(&server->conn_lock);
+        if (server->nconns == server->conns_nalloc) {
+            size_t  new_nalloc = server->conns_nalloc ? server->conns_nalloc * 2 : 16;
+            int    *tmp;
+
+            if (NULL == (tmp = (int *) realloc(server->conn_fds, new_nalloc * sizeof(*tmp)))) {
+                pthread_mutex_unlock(&server->conn_lock);
+                free(args);
+                close(fd);
+                continue;
+            } /* end if */
+            server->conn_fds = tmp;
+            server->conns_nalloc = new_nalloc;
+        } /* end if */
+        server->conn_fds[server->nconns++] = fd;
+        pthread_mutex_unlock(&server->conn_lock);
+
+        pthread_mutex_lock(&server->lock);
+        server->stats.num_connections++;
+        listener->stats.num_connections++;
+        pthread_mutex_unlock(&server->lock);
+
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, mock_connection_thread, args)) {
+            free(args);
+            mock_remove_connection(server, fd);
+            close(fd);
+        } /* end if */
+        pthread_attr_destroy(&attr);
+    } /* end while */
+
+    return NULL;
+} /* end mock_accept_thread() */
+
+int
+rv_mock_hsds_start(rv_mock_hsds_t *server, unsigned short port, unsigned short *bound_port)
+{
+    mock_listener_t    *listener;
+    struct sockaddr_in  addr;
+    socklen_t           addr_len = sizeof(addr);
+    int                 one = 1;
+
+    if (!server || server->nlisteners == MOCK_MAX_LISTENERS)
+        return -1;
+
+    listener = &server->listeners[server->nlisteners];
+    memset(listener, 0, sizeof(*listener));
+    listener->server = server;
+
+    if ((listener->fd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        return -1;
+
+    setsockopt(listener->fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    if (bind(listener->fd, (struct sockaddr *) &addr, sizeof(addr)) < 0
+            || listen(listener->fd, MOCK_LISTEN_BACKLOG) < 0
+            || getsockname(listener->fd, (struct sockaddr *) &addr, &addr_len) < 0)
+        goto error;
+
+    listener->port = ntohs(addr.sin_port);
+
+    /* The listener only becomes visible to the rest of the server once its
+     * accept thread is running
+     */
+    server->running = 1;
+    if (pthread_create(&listener->thread, NULL, mock_accept_thread, listener)) {
+        server->running = server->nlisteners > 0;
+        goto error;
+    } /* end if */
+
+    pthread_mutex_lock(&server->lock);
+    server->nlisteners++;
+    pthread_mutex_unlock(&server->lock);
+
+    if (bound_port)
+        *bound_port = listener->port;
+
+    return 0;
+
+error:
+    close(listener->fd);
+    listener->fd = -1;
+
+    return -1;
+} /* end rv_mock_hsds_start() */
+
+int
+rv_mock_hsds_stop(rv_mock_hsds_t *server)
+{
+    size_t i;
+
+    if (!server || !server->running)
+        return -1;
+
+    /* Wake the accept loops, then shut down every open connection and wait
+     * for the connection threads to exit
+     */
+    server->running = 0;
+    for (i = 0; i < server->nlisteners; i++) {
+        shutdown(server->listeners[i].fd, SHUT_RDWR);
+        pthread_join(server->listeners[i].thread, NULL);
+        close(server->listeners[i].fd);
+    } /* end for */
+
+    pthread_mutex_lock(&server->conn_lock);
+    for (i = 0; i < server->nconns; i++)
+        shutdown(server->conn_fds[i], SHUT_RDWR);
+    while (server->nconns)
+        pthread_cond_wait(&server->conn_cond, &server->conn_lock);
+    pthread_mutex_unlock(&server->conn_lock);
+
+    /* The connection threads are gone, so nothing refers to the listeners */
+    pthread_mutex_lock(&server->lock);
+    server->nlisteners = 0;
+    pthread_mutex_unlock(&server->lock);
+
+    return 0;
+} /* end rv_mock_hsds_stop() */
@@ -0,0 +1,170 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copyright by The HDF Group.                                               *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of HDF5. The full HDF5 copyright notice, including      *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the files COPYING and Copyright.html.  COPYING can be found at the root   *
+ * of the source code distribution tree; Copyright.html can be found at the  *
+ * root level of an installed copy of the electronic document set and is     *
+ * linked from the top-level documents page.  It can also be found at        *
+ * http://hdfgroup.org/HDF5/doc/Copyright.html.  If you do not have access   *
+ * to either file, you may request a copy from help@hdfgroup.org.            *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Purpose: An in-memory stand-in for an HSDS server, used to test and
+ *          benchmark the REST VOL without a real service. The server
+ *          implements the subset of the HDF REST API that the REST VOL
+ *          issues (domains, groups, datasets, committed datatypes, links,
+ *          attributes and dataset values) and can inject a fixed per-request
+ *          latency and a bandwidth limit in order to emulate a remote server.
+ *
+ *          Request handling is kept separate from the socket layer so that
+ *          the same handler can be driven directly, without going through
+ *          TCP, by passing requests to rv_mock_hsds_handle_request().
+ */
+
+#ifndef REST_VOL_MOCK_HSDS_H_
+#define REST_VOL_MOCK_HSDS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rv_mock_hsds_t rv_mock_hsds_t;
+
+/* Settings controlling the emulated network behavior of the mock server */
+typedef struct rv_mock_hsds_config_t {
+    /* Fixed delay added to every request, in microseconds */
+    uint64_t latency_us;
+
+    /* Maximum transfer rate in bytes per second applied to request and
+     * response bodies; 0 means unlimited
+     */
+    uint64_t bandwidth_bytes_per_sec;
+
+    /* Compress the dataset values sent to clients which accept a content
+     * encoding the server supports. Compressed dataset values sent by
+     * clients are always accepted.
+     */
+    int      compress_values;
+
+    /* Print each request to stderr as it is handled */
+    int      verbose;
+
+    /* Value that the Authorization header of every request made over HTTP
+     * must have, such as "Basic dGVzdDp0ZXN0"; requests without it are
+     * answered with 401. NULL accepts any request. The string must stay
+     * valid while the server is running.
+     */
+    const char *authorization;
+} rv_mock_hsds_config_t;
+
+/* A single HTTP request as seen by the request handler */
+typedef struct rv_mock_hsds_request_t {
+    const char *method;
+    const char *path;              /* Path portion of the request target, still URL-encoded */
+    const char *query;             /* Query string without the leading '?', or NULL */
+    const char *domain;            /* Value of the X-Hdf-domain header, or NULL */
+    const char *content_type;      /* Value of the Content-Type header, or NULL */
+    const char *content_encoding;  /* Value of the Content-Encoding header, or NULL */
+    const char *accept_encoding;   /* Value of the Accept-Encoding header, or NULL */
+    const char *body;
+    size_t      body_len;
+} rv_mock_hsds_request_t;
+
+/* The handler's response to a request; body is allocated by the handler
+ * and must be released with rv_mock_hsds_free_response()
+ */
+typedef struct rv_mock_hsds_response_t {
+    int         status;
+    const char *content_type;
+    const char *content_encoding; /* Content-Encoding of the body, or NULL */
+    char       *body;
+    size_t      body_len;
+} rv_mock_hsds_response_t;
+
+/* Faults injected into the responses to the requests made on one of the
+ * ports the server listens on, for testing how the REST VOL copes with an
+ * unreliable server
+ */
+typedef struct rv_mock_hsds_faults_t {
+    /* Number of upcoming requests to answer with fail_status without
+     * handling them; UINT32_MAX makes the port fail for good
+     */
+    uint32_t    fail_count;
+
+    /* HTTP status of the failed requests; 0 means 503 */
+    int         fail_status;
+
+    /* Delay added to every response, in microseconds, on top of the
+     * configured latency, to emulate a server which has stalled
+     */
+    uint64_t    delay_us;
+
+    /* Content-Encoding to label every response with in place of its real
+     * one, or NULL; the string must stay valid while the fault is set
+     */
+    const char *content_encoding;
+
+    /* Number of bytes to cut from the end of every binary response body,
+     * to emulate a server which sends back too little data
+     */
+    size_t      truncate_len;
+} rv_mock_hsds_faults_t;
+
+/* Running totals kept by the mock server */
+typedef struct rv_mock_hsds_stats_t {
+    uint64_t num_requests;
+    uint64_t num_connections;
+    uint64_t bytes_received;
+    uint64_t bytes_sent;
+
+    /* Largest number of requests that were being handled at once, from
+     * when a request was read until its response was ready to be sent
+     */
+    uint64_t max_requests_in_flight;
+
+    /* Number of connections which were still open when the totals were
+     * taken; only kept in the server's totals, not those of each port
+     */
+    uint64_t num_open_connections;
+} rv_mock_hsds_stats_t;
+
+rv_mock_hsds_t *rv_mock_hsds_create(const rv_mock_hsds_config_t *config);
+int             rv_mock_hsds_destroy(rv_mock_hsds_t *server);
+
+/* Start/stop listening for HTTP connections on the loopback interface.
+ * Passing port 0 selects an unused port, which is returned in bound_port.
+ * Starting the server again makes it listen on another port as well,
+ * serving the same objects, so that it can stand in for a server with
+ * several endpoints. Stopping the server closes every port.
+ */
+int rv_mock_hsds_start(rv_mock_hsds_t *server, unsigned short port, unsigned short *bound_port);
+int rv_mock_hsds_stop(rv_mock_hsds_t *server);
+
+int  rv_mock_hsds_handle_request(rv_mock_hsds_t *server, const rv_mock_hsds_request_t *request,
+                                 rv_mock_hsds_response_t *response);
+void rv_mock_hsds_free_response(rv_mock_hsds_response_t *response);
+
+int rv_mock_hsds_get_stats(rv_mock_hsds_t *server, rv_mock_hsds_stats_t *stats);
+
+/* The totals for the requests made on one port, including any which were
+ * failed by an injected fault, which the server-wide totals leave out
+ */
+int rv_mock_hsds_get_port_stats(rv_mock_hsds_t *server, unsigned short port, rv_mock_hsds_stats_t *stats);
+
+/* Set the faults injected on the given port, or on every port the server
+ * is listening on if port is 0
+ */
+int rv_mock_hsds_set_faults(rv_mock_hsds_t *server, unsigned short port, const rv_mock_hsds_faults_t *faults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REST_VOL_MOCK_HSDS_H_ */
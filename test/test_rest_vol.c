@@ -24,11 +24,21 @@
 #include <string.h>
 #include <time.h>
 
+#ifndef WIN32
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/time.h>
+#endif
+
 #include "hdf5.h"
 #include "rest_vol_public.h"
 #include "rest_vol_err.h"
 #include "rest_vol_config.h"
 
+#ifndef WIN32
+#include "rest_vol_mock_hsds.h"
+#endif
+
 #define TEST_DIR_PREFIX "/home"
 #define TEST_FILE_NAME "test_file"
 
@@ -361,9 +371,119 @@ char filename[FILENAME_MAX_LENGTH];
 #define DATASET_DATA_VERIFY_WRITE_TEST_NUM_POINTS      10
 #define DATASET_DATA_VERIFY_WRITE_TEST_DSET_NAME       "dataset_data_verification"
 
+#define DATASET_MULTI_CHUNK_UPLOAD_TEST_NUM_POINTS 262144
+#define DATASET_MULTI_CHUNK_UPLOAD_TEST_DSET_NAME  "multi_chunk_upload_test_dset"
+
+#define DATASET_WRITE_BUFFER_TEST_SPACE_RANK 2
+#define DATASET_WRITE_BUFFER_TEST_NUM_ROWS   100
+#define DATASET_WRITE_BUFFER_TEST_NUM_COLS   10
+#define DATASET_WRITE_BUFFER_TEST_BUF_SIZE   1048576
+#define DATASET_WRITE_BUFFER_TEST_DSET_NAME  "write_buffer_test_dset"
+
+#define DATASET_TYPE_CONVERSION_TEST_NUM_POINTS 100
+#define DATASET_TYPE_CONVERSION_TEST_DSET_DTYPE  H5T_STD_I32BE
+#define DATASET_TYPE_CONVERSION_TEST_DSET_NAME   "type_conversion_test_dset"
+
+#define DATASET_VLEN_IO_TEST_NUM_POINTS   20
+#define DATASET_VLEN_IO_TEST_STR_DSET_NAME "vlen_string_io_test_dset"
+#define DATASET_VLEN_IO_TEST_SEQ_DSET_NAME "vlen_sequence_io_test_dset"
+
 #define DATASET_SET_EXTENT_TEST_SPACE_RANK 2
+#define DATASET_SET_EXTENT_TEST_CHUNK_DIM  4
 #define DATASET_SET_EXTENT_TEST_DSET_NAME  "set_extent_test_dset"
 
+#define DATASET_APPEND_TEST_NUM_COLS    8
+#define DATASET_APPEND_TEST_NUM_APPENDS 25
+#define DATASET_APPEND_TEST_BUF_SIZE    1048576
+#define DATASET_APPEND_TEST_DSET_NAME   "append_test_dset"
+
+#define DATASET_MULTI_IO_TEST_NUM_DSETS    50
+#define DATASET_MULTI_IO_TEST_NUM_POINTS   16
+#define DATASET_MULTI_IO_TEST_DSET_PREFIX  "multi_io_test_dset"
+
+#define DATASET_DISK_CACHE_TEST_NUM_POINTS 100
+#define DATASET_DISK_CACHE_TEST_MAX_SIZE   1048576
+#define DATASET_DISK_CACHE_TEST_DIR        "rest_vol_test_disk_cache"
+#define DATASET_DISK_CACHE_TEST_DSET_NAME  "disk_cache_test_dset"
+
+#define DATASET_REQUEST_STATS_TEST_NUM_POINTS 100
+#define DATASET_REQUEST_STATS_TEST_DSET_NAME  "request_stats_test_dset"
+
+#define DATASET_ENDPOINTS_TEST_NUM_POINTS  100
+#define DATASET_ENDPOINTS_TEST_NUM_PORTS   2
+#define DATASET_ENDPOINTS_TEST_NUM_READS   8
+#define DATASET_ENDPOINTS_TEST_MAX_RETRIES 5
+#define DATASET_ENDPOINTS_TEST_DSET_NAME   "endpoints_test_dset"
+
+#define DATASET_COMPRESSION_TEST_NUM_POINTS 4096
+#define DATASET_COMPRESSION_TEST_DSET_NAME  "compression_test_dset"
+#define DATASET_COMPRESSION_TEST_BAD_CODING "x-bogus"
+
+#define DATASET_RETRY_TEST_NUM_POINTS  100
+#define DATASET_RETRY_TEST_DEADLINE    0.25
+#define DATASET_RETRY_TEST_STALL_US    2000000
+#define DATASET_RETRY_TEST_DSET_NAME   "retry_test_dset"
+
+#define DATASET_TRUNCATED_READ_TEST_NUM_POINTS 100
+#define DATASET_TRUNCATED_READ_TEST_MAX_SIZE   1048576
+#define DATASET_TRUNCATED_READ_TEST_DIR        "rest_vol_test_truncated_read_cache"
+#define DATASET_TRUNCATED_READ_TEST_DSET_NAME  "truncated_read_test_dset"
+
+#define DATASET_PRIORITY_TEST_NUM_BULK      4
+#define DATASET_PRIORITY_TEST_NUM_DSETS     8
+#define DATASET_PRIORITY_TEST_BULK_POINTS   (320 * 1024)
+#define DATASET_PRIORITY_TEST_SMALL_POINTS  1024
+#define DATASET_PRIORITY_TEST_LATENCY_US    20000
+#define DATASET_PRIORITY_TEST_DSET_PREFIX   "priority_test_dset"
+
+#define DATASET_STARVATION_TEST_NUM_BULK      4
+#define DATASET_STARVATION_TEST_BULK_POINTS   (320 * 1024)
+#define DATASET_STARVATION_TEST_SMALL_POINTS  1024
+#define DATASET_STARVATION_TEST_LATENCY_US    50000
+#define DATASET_STARVATION_TEST_FILE          "rest_vol_test_starvation_trace.json"
+#define DATASET_STARVATION_TEST_DSET_PREFIX   "starvation_test_dset"
+
+#define DATASET_WORKER_THREADS_TEST_NUM_ROWS     512
+#define DATASET_WORKER_THREADS_TEST_NUM_COLS     512
+#define DATASET_WORKER_THREADS_TEST_MEM_STRIDE   2
+#define DATASET_WORKER_THREADS_TEST_NUM_THREADS  "4"
+#define DATASET_WORKER_THREADS_TEST_DSET_PREFIX  "worker_threads_test_dset"
+
+#define DATASET_READ_WINDOW_TEST_NUM_ROWS      64
+#define DATASET_READ_WINDOW_TEST_NUM_COLS      256
+#define DATASET_READ_WINDOW_TEST_WINDOW_SIZE   4096
+#define DATASET_READ_WINDOW_TEST_SMALL_WINDOW  512
+#define DATASET_READ_WINDOW_TEST_NUM_POINTS    300
+#define DATASET_READ_WINDOW_TEST_DSET_NAME     "read_window_test_dset"
+
+#define DATASET_TRACE_TEST_NUM_POINTS 100
+#define DATASET_TRACE_TEST_FILE       "rest_vol_test_trace.json"
+#define DATASET_TRACE_TEST_DSET_NAME  "trace_test_dset"
+
+#define DATASET_LOOPBACK_TEST_NUM_ROWS  32
+#define DATASET_LOOPBACK_TEST_NUM_COLS  64
+#define DATASET_LOOPBACK_TEST_DSET_NAME "loopback_test_dset"
+
+#define DATASET_HTTP2_TEST_NUM_DSETS   8
+#define DATASET_HTTP2_TEST_NUM_POINTS  4096
+#define DATASET_HTTP2_TEST_LATENCY_US  10000
+#define DATASET_HTTP2_TEST_DSET_PREFIX "http2_test_dset"
+
+#define DATASET_CONNECTION_REUSE_TEST_NUM_POINTS 100
+#define DATASET_CONNECTION_REUSE_TEST_CLOSE_MS   5000
+#define DATASET_CONNECTION_REUSE_TEST_DSET_NAME  "connection_reuse_test_dset"
+
+#define DATASET_CREDENTIALS_TEST_NUM_POINTS   100
+#define DATASET_CREDENTIALS_TEST_USERNAME     "alice"
+#define DATASET_CREDENTIALS_TEST_BAD_USERNAME "mallory"
+#define DATASET_CREDENTIALS_TEST_PASSWORD     "secret"
+#define DATASET_CREDENTIALS_TEST_AUTH         "Basic YWxpY2U6c2VjcmV0"
+#define DATASET_CREDENTIALS_TEST_DSET_NAME    "credentials_test_dset"
+
+#define DATASET_QUERY_TEST_NUM_POINTS 100
+#define DATASET_QUERY_TEST_DSET_NAME  "query_test_dset"
+#define DATASET_QUERY_TEST_QUERY      "(temp > 300) & (pressure < 10)"
+
 #define DATASET_UNUSED_APIS_TEST_SPACE_RANK 2
 #define DATASET_UNUSED_APIS_TEST_DSET_NAME  "unused_apis_dset"
 
@@ -688,7 +808,31 @@ static int test_read_dataset_large_hyperslab(void);
 static int test_read_dataset_large_point_selection(void);
 #endif
 static int test_write_dataset_data_verification(void);
+static int test_write_dataset_multi_chunk_upload(void);
+static int test_write_dataset_write_buffer(void);
+static int test_dataset_type_conversion(void);
+static int test_dataset_vlen_io(void);
 static int test_dataset_set_extent(void);
+static int test_dataset_append(void);
+static int test_dataset_multi_io(void);
+static int test_dataset_query(void);
+static int test_dataset_disk_cache(void);
+static int test_dataset_request_stats(void);
+#ifndef WIN32
+static int test_dataset_endpoints(void);
+static int test_dataset_compression(void);
+static int test_dataset_retry(void);
+static int test_dataset_truncated_read(void);
+static int test_dataset_priority(void);
+static int test_dataset_priority_starvation(void);
+static int test_dataset_worker_threads(void);
+static int test_dataset_read_window(void);
+static int test_dataset_trace(void);
+static int test_dataset_loopback(void);
+static int test_dataset_http2(void);
+static int test_dataset_connection_reuse(void);
+static int test_dataset_changed_credentials(void);
+#endif
 static int test_unused_dataset_API_calls(void);
 static int test_dataset_property_lists(void);
 
@@ -766,6 +910,13 @@ static herr_t object_visit_callback(hid_t o_id, const char *name, const H5O_info
 
 static hid_t generate_random_datatype(H5T_class_t parent_class);
 
+static herr_t remove_disk_cache_dir(const char *dir);
+
+#ifndef WIN32
+static rv_mock_hsds_t *start_mock_server(const rv_mock_hsds_config_t *config, size_t num_ports, unsigned short ports[],
+                                         char *endpoints, size_t endpoints_size);
+#endif
+
 static int (*setup_tests[])(void) = {
         test_setup_plugin,
         NULL
@@ -847,7 +998,31 @@ static int (*dataset_tests[])(void) = {
         test_read_dataset_large_point_selection,
 #endif
         test_write_dataset_data_verification,
+        test_write_dataset_multi_chunk_upload,
+        test_write_dataset_write_buffer,
+        test_dataset_type_conversion,
+        test_dataset_vlen_io,
         test_dataset_set_extent,
+        test_dataset_append,
+        test_dataset_multi_io,
+        test_dataset_query,
+        test_dataset_disk_cache,
+        test_dataset_request_stats,
+#ifndef WIN32
+        test_dataset_endpoints,
+        test_dataset_compression,
+        test_dataset_retry,
+        test_dataset_truncated_read,
+        test_dataset_priority,
+        test_dataset_priority_starvation,
+        test_dataset_worker_threads,
+        test_dataset_read_window,
+        test_dataset_trace,
+        test_dataset_loopback,
+        test_dataset_http2,
+        test_dataset_connection_reuse,
+        test_dataset_changed_credentials,
+#endif
         test_unused_dataset_API_calls,
         test_dataset_property_lists,
         NULL
@@ -1496,8 +1671,6 @@ test_unused_file_API_calls(void)
 
         if (H5Fis_accessible(filename, fapl_id) >= 0)
             TEST_ERROR
-        if (H5Fflush(file_id, H5F_SCOPE_GLOBAL) >= 0)
-            TEST_ERROR
         if (H5Fget_obj_count(file_id, H5F_OBJ_DATASET) >= 0)
             TEST_ERROR
         if (H5Fget_obj_ids(file_id, H5F_OBJ_DATASET, 0, &obj_id) >= 0)
@@ -8705,18 +8878,18 @@ error:
 }
 
 static int
-test_dataset_set_extent(void)
+test_write_dataset_multi_chunk_upload(void)
 {
-    hsize_t dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
-    hsize_t new_dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
+    hsize_t dims[1] = { DATASET_MULTI_CHUNK_UPLOAD_TEST_NUM_POINTS };
     size_t  i;
     hid_t   file_id = -1, fapl_id = -1;
     hid_t   container_group = -1;
     hid_t   dset_id = -1;
-    hid_t   dset_dtype = -1;
     hid_t   fspace_id = -1;
+    int    *write_buf = NULL;
+    int    *read_buf = NULL;
 
-    TESTING("set dataset extent")
+    TESTING("write to dataset in multiple upload chunks")
 
     if (RVinit() < 0)
         TEST_ERROR
@@ -8738,40 +8911,51 @@ test_dataset_set_extent(void)
         goto error;
     }
 
-    for (i = 0; i < DATASET_SET_EXTENT_TEST_SPACE_RANK; i++)
-        dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
-    for (i = 0; i < DATASET_SET_EXTENT_TEST_SPACE_RANK; i++)
-        new_dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
-
-    if ((fspace_id = H5Screate_simple(DATASET_SET_EXTENT_TEST_SPACE_RANK, dims, NULL)) < 0)
-        TEST_ERROR
-
-    if ((dset_dtype = generate_random_datatype(H5T_NO_CLASS)) < 0)
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
         TEST_ERROR
 
-    if ((dset_id = H5Dcreate2(container_group, DATASET_SET_EXTENT_TEST_DSET_NAME, dset_dtype,
+    if ((dset_id = H5Dcreate2(container_group, DATASET_MULTI_CHUNK_UPLOAD_TEST_DSET_NAME, H5T_NATIVE_INT,
             fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
         H5_FAILED();
         printf("    couldn't create dataset\n");
         goto error;
     }
 
-#ifdef RV_PLUGIN_DEBUG
-    puts("Testing use of H5Dset_extent to change dataset's extent\n");
-#endif
+    /* 1MB of data is several times the size of cURL's upload buffer */
+    if (NULL == (write_buf = (int *) malloc(DATASET_MULTI_CHUNK_UPLOAD_TEST_NUM_POINTS * sizeof(int))))
+        TEST_ERROR
+    if (NULL == (read_buf = (int *) calloc(DATASET_MULTI_CHUNK_UPLOAD_TEST_NUM_POINTS, sizeof(int))))
+        TEST_ERROR
 
-    H5E_BEGIN_TRY {
-        if (H5Dset_extent(dset_id, new_dims) >= 0) {
+    for (i = 0; i < DATASET_MULTI_CHUNK_UPLOAD_TEST_NUM_POINTS; i++)
+        write_buf[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, write_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_MULTI_CHUNK_UPLOAD_TEST_NUM_POINTS; i++)
+        if (read_buf[i] != write_buf[i]) {
             H5_FAILED();
-            printf("    unsupported API succeeded!\n");
+            printf("    data read back didn't match data written at index %zu\n", i);
             goto error;
         }
-    } H5E_END_TRY;
+
+    free(write_buf);
+    write_buf = NULL;
+    free(read_buf);
+    read_buf = NULL;
 
     if (H5Sclose(fspace_id) < 0)
         TEST_ERROR
-    if (H5Tclose(dset_dtype) < 0)
-        TEST_ERROR
     if (H5Dclose(dset_id) < 0)
         TEST_ERROR
     if (H5Gclose(container_group) < 0)
@@ -8789,8 +8973,9 @@ test_dataset_set_extent(void)
 
 error:
     H5E_BEGIN_TRY {
+        if (write_buf) free(write_buf);
+        if (read_buf) free(read_buf);
         H5Sclose(fspace_id);
-        H5Tclose(dset_dtype);
         H5Dclose(dset_id);
         H5Gclose(container_group);
         H5Pclose(fapl_id);
@@ -8802,18 +8987,22 @@ error:
 }
 
 static int
-test_unused_dataset_API_calls(void)
+test_write_dataset_write_buffer(void)
 {
-    H5D_space_status_t allocation;
-    hsize_t            dims[DATASET_UNUSED_APIS_TEST_SPACE_RANK];
-    size_t             i;
-    hid_t              file_id = -1, fapl_id = -1;
-    hid_t              container_group = -1;
-    hid_t              dset_id = -1;
-    hid_t              dset_dtype = -1;
-    hid_t              fspace_id = -1;
+    hsize_t dims[DATASET_WRITE_BUFFER_TEST_SPACE_RANK] = { DATASET_WRITE_BUFFER_TEST_NUM_ROWS, DATASET_WRITE_BUFFER_TEST_NUM_COLS };
+    hsize_t start[DATASET_WRITE_BUFFER_TEST_SPACE_RANK];
+    hsize_t count[DATASET_WRITE_BUFFER_TEST_SPACE_RANK];
+    size_t  buf_size;
+    size_t  i, j;
+    hid_t   file_id = -1, fapl_id = -1;
+    hid_t   container_group = -1;
+    hid_t   dset_id = -1;
+    hid_t   fspace_id = -1;
+    hid_t   mspace_id = -1;
+    int     data[DATASET_WRITE_BUFFER_TEST_NUM_ROWS][DATASET_WRITE_BUFFER_TEST_NUM_COLS];
+    int     read_buf[DATASET_WRITE_BUFFER_TEST_NUM_ROWS][DATASET_WRITE_BUFFER_TEST_NUM_COLS];
 
-    TESTING("unused dataset API calls")
+    TESTING("buffered dataset writes")
 
     if (RVinit() < 0)
         TEST_ERROR
@@ -8822,6 +9011,16 @@ test_unused_dataset_API_calls(void)
         TEST_ERROR
     if (H5Pset_fapl_rest_vol(fapl_id) < 0)
         TEST_ERROR
+    if (H5Pset_fapl_rest_vol_write_buffer(fapl_id, DATASET_WRITE_BUFFER_TEST_BUF_SIZE) < 0)
+        TEST_ERROR
+    if (H5Pget_fapl_rest_vol_write_buffer(fapl_id, &buf_size) < 0)
+        TEST_ERROR
+
+    if (buf_size != DATASET_WRITE_BUFFER_TEST_BUF_SIZE) {
+        H5_FAILED();
+        printf("    write buffer size retrieved from FAPL didn't match\n");
+        goto error;
+    }
 
     if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
         H5_FAILED();
@@ -8835,39 +9034,112 @@ test_unused_dataset_API_calls(void)
         goto error;
     }
 
-    for (i = 0; i < DATASET_UNUSED_APIS_TEST_SPACE_RANK; i++)
-        dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
-
-    if ((fspace_id = H5Screate_simple(DATASET_UNUSED_APIS_TEST_SPACE_RANK, dims, NULL)) < 0)
-        TEST_ERROR
-
-    if ((dset_dtype = generate_random_datatype(H5T_NO_CLASS)) < 0)
+    if ((fspace_id = H5Screate_simple(DATASET_WRITE_BUFFER_TEST_SPACE_RANK, dims, NULL)) < 0)
         TEST_ERROR
 
-    if ((dset_id = H5Dcreate2(container_group, DATASET_UNUSED_APIS_TEST_DSET_NAME, dset_dtype,
+    if ((dset_id = H5Dcreate2(container_group, DATASET_WRITE_BUFFER_TEST_DSET_NAME, H5T_NATIVE_INT,
             fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
         H5_FAILED();
         printf("    couldn't create dataset\n");
         goto error;
     }
 
+    for (i = 0; i < DATASET_WRITE_BUFFER_TEST_NUM_ROWS; i++)
+        for (j = 0; j < DATASET_WRITE_BUFFER_TEST_NUM_COLS; j++)
+            data[i][j] = (int) ((i * DATASET_WRITE_BUFFER_TEST_NUM_COLS) + j);
+
 #ifdef RV_PLUGIN_DEBUG
-    puts("Testing that all of the unused dataset API calls don't cause application issues\n");
+    puts("Writing to dataset one row at a time\n");
 #endif
 
-    H5E_BEGIN_TRY {
-        if (H5Dget_storage_size(dset_id) > 0)
-            TEST_ERROR
-        if (H5Dget_space_status(dset_id, &allocation) > 0)
-            TEST_ERROR
-        if (H5Dget_offset(dset_id) != HADDR_UNDEF)
+    count[0] = 1;
+    count[1] = DATASET_WRITE_BUFFER_TEST_NUM_COLS;
+    if ((mspace_id = H5Screate_simple(1, &count[1], NULL)) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < DATASET_WRITE_BUFFER_TEST_NUM_ROWS; i++) {
+        start[0] = i;
+        start[1] = 0;
+
+        if (H5Sselect_hyperslab(fspace_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
             TEST_ERROR
-    } H5E_END_TRY;
 
+        if (H5Dwrite(dset_id, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, data[i]) < 0) {
+            H5_FAILED();
+            printf("    couldn't write row %zu to dataset\n", i);
+            goto error;
+        }
+    }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    mspace_id = -1;
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Overwriting a block within the previously-written rows\n");
+#endif
+
+    start[0] = 10;
+    start[1] = 2;
+    count[0] = 5;
+    count[1] = 5;
+
+    for (i = 0; i < count[0]; i++)
+        for (j = 0; j < count[1]; j++)
+            data[start[0] + i][start[1] + j] = -1;
+
+    if ((mspace_id = H5Screate_simple(DATASET_WRITE_BUFFER_TEST_SPACE_RANK, dims, NULL)) < 0)
+        TEST_ERROR
+    if (H5Sselect_hyperslab(mspace_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        TEST_ERROR
+    if (H5Sselect_hyperslab(fspace_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        TEST_ERROR
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Fflush(file_id, H5F_SCOPE_GLOBAL) < 0) {
+        H5_FAILED();
+        printf("    couldn't flush file\n");
+        goto error;
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Verifying that the buffered writes reached the dataset\n");
+#endif
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    mspace_id = -1;
     if (H5Sclose(fspace_id) < 0)
         TEST_ERROR
-    if (H5Tclose(dset_dtype) < 0)
+    fspace_id = -1;
+    if (H5Dclose(dset_id) < 0)
         TEST_ERROR
+
+    if ((dset_id = H5Dopen2(file_id, "/" DATASET_TEST_GROUP_NAME "/" DATASET_WRITE_BUFFER_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    if (memcmp(data, read_buf, sizeof(data))) {
+        H5_FAILED();
+        printf("    buffered write data verification failed\n");
+        goto error;
+    }
+
     if (H5Dclose(dset_id) < 0)
         TEST_ERROR
     if (H5Gclose(container_group) < 0)
@@ -8885,8 +9157,8 @@ test_unused_dataset_API_calls(void)
 
 error:
     H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
         H5Sclose(fspace_id);
-        H5Tclose(dset_dtype);
         H5Dclose(dset_id);
         H5Gclose(container_group);
         H5Pclose(fapl_id);
@@ -8898,22 +9170,23 @@ error:
 }
 
 static int
-test_dataset_property_lists(void)
+test_dataset_type_conversion(void)
 {
-    const char *path_prefix = "/test_prefix";
-    hsize_t     dims[DATASET_PROPERTY_LIST_TEST_SPACE_RANK];
-    hsize_t     chunk_dims[DATASET_PROPERTY_LIST_TEST_SPACE_RANK];
-    size_t      i;
-    hid_t       file_id = -1, fapl_id = -1;
-    hid_t       container_group = -1, group_id = -1;
-    hid_t       dset_id1 = -1, dset_id2 = -1, dset_id3 = -1, dset_id4 = -1;
-    hid_t       dcpl_id1 = -1, dcpl_id2 = -1;
-    hid_t       dapl_id1 = -1, dapl_id2 = -1;
-    hid_t       dset_dtype1 = -1, dset_dtype2 = -1, dset_dtype3 = -1, dset_dtype4 = -1;
-    hid_t       space_id = -1;
-    char       *tmp_prefix = NULL;
+    hsize_t dims[1] = { DATASET_TYPE_CONVERSION_TEST_NUM_POINTS };
+    hsize_t mem_dims[1] = { 2 * DATASET_TYPE_CONVERSION_TEST_NUM_POINTS };
+    hsize_t start[1] = { 0 };
+    hsize_t stride[1] = { 2 };
+    size_t  i;
+    hid_t   file_id = -1, fapl_id = -1;
+    hid_t   container_group = -1;
+    hid_t   dset_id = -1;
+    hid_t   fspace_id = -1;
+    hid_t   mspace_id = -1;
+    short   write_buf[DATASET_TYPE_CONVERSION_TEST_NUM_POINTS];
+    int     int_read_buf[DATASET_TYPE_CONVERSION_TEST_NUM_POINTS];
+    double  double_read_buf[2 * DATASET_TYPE_CONVERSION_TEST_NUM_POINTS];
 
-    TESTING("dataset property list operations")
+    TESTING("conversion of dataset data between datatypes")
 
     if (RVinit() < 0)
         TEST_ERROR
@@ -8935,116 +9208,4141 @@ test_dataset_property_lists(void)
         goto error;
     }
 
-    if ((group_id = H5Gcreate2(container_group, DATASET_PROPERTY_LIST_TEST_SUBGROUP_NAME, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
-        H5_FAILED();
-        printf("    couldn't create container sub-group\n");
-        goto error;
-    }
-
-    for (i = 0; i < DATASET_PROPERTY_LIST_TEST_SPACE_RANK; i++)
-        dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
-    for (i = 0; i < DATASET_PROPERTY_LIST_TEST_SPACE_RANK; i++)
-        chunk_dims[i] = (hsize_t) (rand() % (int) dims[i] + 1);
-
-    if ((space_id = H5Screate_simple(DATASET_PROPERTY_LIST_TEST_SPACE_RANK, dims, NULL)) < 0)
-        TEST_ERROR
-
-    if ((dset_dtype1 = generate_random_datatype(H5T_NO_CLASS)) < 0)
-        TEST_ERROR
-    if ((dset_dtype2 = generate_random_datatype(H5T_NO_CLASS)) < 0)
-        TEST_ERROR
-    if ((dset_dtype3 = generate_random_datatype(H5T_NO_CLASS)) < 0)
-        TEST_ERROR
-    if ((dset_dtype4 = generate_random_datatype(H5T_NO_CLASS)) < 0)
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
         TEST_ERROR
 
-    if ((dcpl_id1 = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+    if ((dset_id = H5Dcreate2(container_group, DATASET_TYPE_CONVERSION_TEST_DSET_NAME, DATASET_TYPE_CONVERSION_TEST_DSET_DTYPE,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
         H5_FAILED();
-        printf("    couldn't create DCPL\n");
+        printf("    couldn't create dataset\n");
         goto error;
     }
 
+    for (i = 0; i < DATASET_TYPE_CONVERSION_TEST_NUM_POINTS; i++)
+        write_buf[i] = (short) (i * 300 - 15000);
+
 #ifdef RV_PLUGIN_DEBUG
-    puts("Setting property on DCPL\n");
+    puts("Writing native short data to big-endian 32-bit integer dataset\n");
 #endif
 
-    if (H5Pset_chunk(dcpl_id1, DATASET_PROPERTY_LIST_TEST_SPACE_RANK, chunk_dims) < 0) {
-        H5_FAILED();
-        printf("    couldn't set DCPL property\n");
-        goto error;
-    }
-
-    if ((dset_id1 = H5Dcreate2(group_id, DATASET_PROPERTY_LIST_TEST_DSET_NAME1, dset_dtype1,
-            space_id, H5P_DEFAULT, dcpl_id1, H5P_DEFAULT)) < 0) {
-        H5_FAILED();
-        printf("    couldn't create dataset\n");
-        goto error;
-    }
-
-    if ((dset_id2 = H5Dcreate2(group_id, DATASET_PROPERTY_LIST_TEST_DSET_NAME2, dset_dtype2,
-            space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+    if (H5Dwrite(dset_id, H5T_NATIVE_SHORT, H5S_ALL, H5S_ALL, H5P_DEFAULT, write_buf) < 0) {
         H5_FAILED();
-        printf("    couldn't create dataset\n");
+        printf("    couldn't write to dataset\n");
         goto error;
     }
 
-    if (H5Pclose(dcpl_id1) < 0)
-        TEST_ERROR
-
-    /* Try to receive copies of the two property lists, one which has the property set and one which does not */
-    if ((dcpl_id1 = H5Dget_create_plist(dset_id1)) < 0) {
-        H5_FAILED();
-        printf("    couldn't get property list\n");
-        goto error;
-    }
+#ifdef RV_PLUGIN_DEBUG
+    puts("Reading dataset data back as native int\n");
+#endif
 
-    if ((dcpl_id2 = H5Dget_create_plist(dset_id2)) < 0) {
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, int_read_buf) < 0) {
         H5_FAILED();
-        printf("    couldn't get property list\n");
+        printf("    couldn't read from dataset\n");
         goto error;
     }
 
-    /* Ensure that property list 1 has the property set and property list 2 does not */
-    {
-        hsize_t tmp_chunk_dims[DATASET_PROPERTY_LIST_TEST_SPACE_RANK];
-
-        memset(tmp_chunk_dims, 0, sizeof(tmp_chunk_dims));
-
-        if (H5Pget_chunk(dcpl_id1, DATASET_PROPERTY_LIST_TEST_SPACE_RANK, tmp_chunk_dims) < 0) {
+    for (i = 0; i < DATASET_TYPE_CONVERSION_TEST_NUM_POINTS; i++)
+        if (int_read_buf[i] != (int) write_buf[i]) {
             H5_FAILED();
-            printf("    couldn't get DCPL property value\n");
+            printf("    int data verification failed at index %zu\n", i);
             goto error;
         }
 
 #ifdef RV_PLUGIN_DEBUG
-    puts("Ensuring that the property on the DCPL was received back correctly\n");
+    puts("Reading dataset data back as native double into every other buffer element\n");
 #endif
 
-        for (i = 0; i < DATASET_PROPERTY_LIST_TEST_SPACE_RANK; i++)
-            if (tmp_chunk_dims[i] != chunk_dims[i]) {
-                H5_FAILED();
-                printf("    DCPL property values were incorrect\n");
-                goto error;
-            }
+    memset(double_read_buf, 0, sizeof(double_read_buf));
 
-        H5E_BEGIN_TRY {
-            if (H5Pget_chunk(dcpl_id2, DATASET_PROPERTY_LIST_TEST_SPACE_RANK, tmp_chunk_dims) >= 0) {
-                H5_FAILED();
-                printf("    property list 2 shouldn't have had chunk dimensionality set (not a chunked layout)\n");
-                goto error;
-            }
-        } H5E_END_TRY;
-    }
+    if ((mspace_id = H5Screate_simple(1, mem_dims, NULL)) < 0)
+        TEST_ERROR
+    if (H5Sselect_hyperslab(mspace_id, H5S_SELECT_SET, start, stride, dims, NULL) < 0)
+        TEST_ERROR
 
-    if ((dapl_id1 = H5Pcreate(H5P_DATASET_ACCESS)) < 0) {
+    if (H5Dread(dset_id, H5T_NATIVE_DOUBLE, mspace_id, H5S_ALL, H5P_DEFAULT, double_read_buf) < 0) {
         H5_FAILED();
-        printf("    couldn't create DAPL\n");
+        printf("    couldn't read from dataset\n");
         goto error;
     }
 
-#ifdef RV_PLUGIN_DEBUG
-    puts("Setting property on DAPL\n");
-#endif
+    for (i = 0; i < DATASET_TYPE_CONVERSION_TEST_NUM_POINTS; i++)
+        if ((double_read_buf[2 * i] != (double) write_buf[i]) || (double_read_buf[2 * i + 1] != 0.0)) {
+            H5_FAILED();
+            printf("    double data verification failed at index %zu\n", i);
+            goto error;
+        }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_vlen_io(void)
+{
+    hsize_t  dims[1] = { DATASET_VLEN_IO_TEST_NUM_POINTS };
+    size_t   i, j;
+    hid_t    file_id = -1, fapl_id = -1;
+    hid_t    container_group = -1;
+    hid_t    str_dset_id = -1, seq_dset_id = -1;
+    hid_t    str_dtype = -1, seq_dtype = -1;
+    hid_t    fspace_id = -1;
+    char     str_data[DATASET_VLEN_IO_TEST_NUM_POINTS][DATASET_VLEN_IO_TEST_NUM_POINTS + 1];
+    char    *str_write_buf[DATASET_VLEN_IO_TEST_NUM_POINTS];
+    char    *str_read_buf[DATASET_VLEN_IO_TEST_NUM_POINTS];
+    int      seq_data[DATASET_VLEN_IO_TEST_NUM_POINTS][DATASET_VLEN_IO_TEST_NUM_POINTS];
+    hvl_t    seq_write_buf[DATASET_VLEN_IO_TEST_NUM_POINTS];
+    hvl_t    seq_read_buf[DATASET_VLEN_IO_TEST_NUM_POINTS];
+    hbool_t  str_read = FALSE, seq_read = FALSE;
+
+    TESTING("read/write of variable-length data")
+
+    memset(str_read_buf, 0, sizeof(str_read_buf));
+    memset(seq_read_buf, 0, sizeof(seq_read_buf));
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((str_dtype = H5Tcopy(H5T_C_S1)) < 0)
+        TEST_ERROR
+    if (H5Tset_size(str_dtype, H5T_VARIABLE) < 0)
+        TEST_ERROR
+    if ((seq_dtype = H5Tvlen_create(H5T_NATIVE_INT)) < 0)
+        TEST_ERROR
+
+    if ((str_dset_id = H5Dcreate2(container_group, DATASET_VLEN_IO_TEST_STR_DSET_NAME, str_dtype,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create variable-length string dataset\n");
+        goto error;
+    }
+
+    if ((seq_dset_id = H5Dcreate2(container_group, DATASET_VLEN_IO_TEST_SEQ_DSET_NAME, seq_dtype,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create variable-length sequence dataset\n");
+        goto error;
+    }
+
+    /* Element i of each dataset holds i characters or integers */
+    for (i = 0; i < DATASET_VLEN_IO_TEST_NUM_POINTS; i++) {
+        for (j = 0; j < i; j++) {
+            str_data[i][j] = (char) ('a' + (char) ((i + j) % 26));
+            seq_data[i][j] = (int) (i * j);
+        }
+        str_data[i][i] = '\0';
+
+        str_write_buf[i] = str_data[i];
+        seq_write_buf[i].len = i;
+        seq_write_buf[i].p = seq_data[i];
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Writing variable-length data\n");
+#endif
+
+    if (H5Dwrite(str_dset_id, str_dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, str_write_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to variable-length string dataset\n");
+        goto error;
+    }
+
+    if (H5Dwrite(seq_dset_id, seq_dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, seq_write_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to variable-length sequence dataset\n");
+        goto error;
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Reading back variable-length data\n");
+#endif
+
+    if (H5Dread(str_dset_id, str_dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, str_read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from variable-length string dataset\n");
+        goto error;
+    }
+    str_read = TRUE;
+
+    if (H5Dread(seq_dset_id, seq_dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, seq_read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from variable-length sequence dataset\n");
+        goto error;
+    }
+    seq_read = TRUE;
+
+    for (i = 0; i < DATASET_VLEN_IO_TEST_NUM_POINTS; i++) {
+        if (!str_read_buf[i] || strcmp(str_read_buf[i], str_data[i])) {
+            H5_FAILED();
+            printf("    variable-length string data verification failed at index %zu\n", i);
+            goto error;
+        }
+
+        if ((seq_read_buf[i].len != i) || (i && memcmp(seq_read_buf[i].p, seq_data[i], i * sizeof(int)))) {
+            H5_FAILED();
+            printf("    variable-length sequence data verification failed at index %zu\n", i);
+            goto error;
+        }
+    }
+
+    if (H5Dvlen_reclaim(str_dtype, fspace_id, H5P_DEFAULT, str_read_buf) < 0)
+        TEST_ERROR
+    str_read = FALSE;
+    if (H5Dvlen_reclaim(seq_dtype, fspace_id, H5P_DEFAULT, seq_read_buf) < 0)
+        TEST_ERROR
+    seq_read = FALSE;
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Tclose(str_dtype) < 0)
+        TEST_ERROR
+    if (H5Tclose(seq_dtype) < 0)
+        TEST_ERROR
+    if (H5Dclose(str_dset_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(seq_dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        if (str_read) H5Dvlen_reclaim(str_dtype, fspace_id, H5P_DEFAULT, str_read_buf);
+        if (seq_read) H5Dvlen_reclaim(seq_dtype, fspace_id, H5P_DEFAULT, seq_read_buf);
+        H5Sclose(fspace_id);
+        H5Tclose(str_dtype);
+        H5Tclose(seq_dtype);
+        H5Dclose(str_dset_id);
+        H5Dclose(seq_dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_set_extent(void)
+{
+    hsize_t dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
+    hsize_t max_dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
+    hsize_t chunk_dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
+    hsize_t new_dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
+    hsize_t retrieved_dims[DATASET_SET_EXTENT_TEST_SPACE_RANK];
+    size_t  i;
+    hid_t   file_id = -1, fapl_id = -1;
+    hid_t   container_group = -1;
+    hid_t   dset_id = -1;
+    hid_t   dset_dtype = -1;
+    hid_t   dcpl_id = -1;
+    hid_t   fspace_id = -1;
+
+    TESTING("set dataset extent")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_SET_EXTENT_TEST_SPACE_RANK; i++) {
+        dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
+        max_dims[i] = H5S_UNLIMITED;
+        chunk_dims[i] = DATASET_SET_EXTENT_TEST_CHUNK_DIM;
+    }
+    for (i = 0; i < DATASET_SET_EXTENT_TEST_SPACE_RANK; i++)
+        new_dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
+
+    if ((fspace_id = H5Screate_simple(DATASET_SET_EXTENT_TEST_SPACE_RANK, dims, max_dims)) < 0)
+        TEST_ERROR
+
+    if ((dset_dtype = generate_random_datatype(H5T_NO_CLASS)) < 0)
+        TEST_ERROR
+
+    if ((dcpl_id = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        TEST_ERROR
+    if (H5Pset_chunk(dcpl_id, DATASET_SET_EXTENT_TEST_SPACE_RANK, chunk_dims) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(container_group, DATASET_SET_EXTENT_TEST_DSET_NAME, dset_dtype,
+            fspace_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    fspace_id = -1;
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Testing use of H5Dset_extent to change dataset's extent\n");
+#endif
+
+    if (H5Dset_extent(dset_id, new_dims) < 0) {
+        H5_FAILED();
+        printf("    couldn't set dataset extent\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Dget_space(dset_id)) < 0)
+        TEST_ERROR
+    if (H5Sget_simple_extent_dims(fspace_id, retrieved_dims, NULL) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < DATASET_SET_EXTENT_TEST_SPACE_RANK; i++)
+        if (retrieved_dims[i] != new_dims[i]) {
+            H5_FAILED();
+            printf("    dataset's dataspace dimension %zu was %llu instead of %llu after H5Dset_extent\n",
+                    i, (unsigned long long) retrieved_dims[i], (unsigned long long) new_dims[i]);
+            goto error;
+        }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    fspace_id = -1;
+
+    /* Re-open the dataset to make sure that the server has the new extent */
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dopen2(container_group, DATASET_SET_EXTENT_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Dget_space(dset_id)) < 0)
+        TEST_ERROR
+    if (H5Sget_simple_extent_dims(fspace_id, retrieved_dims, NULL) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < DATASET_SET_EXTENT_TEST_SPACE_RANK; i++)
+        if (retrieved_dims[i] != new_dims[i]) {
+            H5_FAILED();
+            printf("    re-opened dataset's dataspace dimension %zu was %llu instead of %llu\n",
+                    i, (unsigned long long) retrieved_dims[i], (unsigned long long) new_dims[i]);
+            goto error;
+        }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(dcpl_id) < 0)
+        TEST_ERROR
+    if (H5Tclose(dset_dtype) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Pclose(dcpl_id);
+        H5Tclose(dset_dtype);
+        H5Dclose(dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_append(void)
+{
+    hsize_t dims[2] = { 0, DATASET_APPEND_TEST_NUM_COLS };
+    hsize_t max_dims[2] = { H5S_UNLIMITED, DATASET_APPEND_TEST_NUM_COLS };
+    hsize_t chunk_dims[2] = { DATASET_APPEND_TEST_NUM_APPENDS, DATASET_APPEND_TEST_NUM_COLS };
+    hsize_t retrieved_dims[2];
+    size_t  i, j;
+    hid_t   file_id = -1, fapl_id = -1;
+    hid_t   container_group = -1;
+    hid_t   dset_id = -1;
+    hid_t   dcpl_id = -1;
+    hid_t   fspace_id = -1;
+    int     row[DATASET_APPEND_TEST_NUM_COLS];
+    int     read_buf[DATASET_APPEND_TEST_NUM_APPENDS][DATASET_APPEND_TEST_NUM_COLS];
+
+    TESTING("append to dataset")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    /* Use write-back buffering so that the appends are batched together */
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_write_buffer(fapl_id, DATASET_APPEND_TEST_BUF_SIZE) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(2, dims, max_dims)) < 0)
+        TEST_ERROR
+
+    if ((dcpl_id = H5Pcreate(H5P_DATASET_CREATE)) < 0)
+        TEST_ERROR
+    if (H5Pset_chunk(dcpl_id, 2, chunk_dims) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(container_group, DATASET_APPEND_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    fspace_id = -1;
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Appending rows to dataset\n");
+#endif
+
+    for (i = 0; i < DATASET_APPEND_TEST_NUM_APPENDS; i++) {
+        for (j = 0; j < DATASET_APPEND_TEST_NUM_COLS; j++)
+            row[j] = (int) (i * DATASET_APPEND_TEST_NUM_COLS + j);
+
+        if (RVdataset_append(dset_id, H5P_DEFAULT, 0, 1, H5T_NATIVE_INT, row) < 0) {
+            H5_FAILED();
+            printf("    couldn't append row %zu to dataset\n", i);
+            goto error;
+        }
+    }
+
+    if ((fspace_id = H5Dget_space(dset_id)) < 0)
+        TEST_ERROR
+    if (H5Sget_simple_extent_dims(fspace_id, retrieved_dims, NULL) < 0)
+        TEST_ERROR
+
+    if (retrieved_dims[0] != DATASET_APPEND_TEST_NUM_APPENDS || retrieved_dims[1] != DATASET_APPEND_TEST_NUM_COLS) {
+        H5_FAILED();
+        printf("    dataset's dimensions were %llu x %llu after appending\n",
+                (unsigned long long) retrieved_dims[0], (unsigned long long) retrieved_dims[1]);
+        goto error;
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    fspace_id = -1;
+
+    /* Reading the dataset sends the buffered extent and data to the server first */
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_APPEND_TEST_NUM_APPENDS; i++)
+        for (j = 0; j < DATASET_APPEND_TEST_NUM_COLS; j++)
+            if (read_buf[i][j] != (int) (i * DATASET_APPEND_TEST_NUM_COLS + j)) {
+                H5_FAILED();
+                printf("    appended data verification failed\n");
+                goto error;
+            }
+
+    if (H5Pclose(dcpl_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Pclose(dcpl_id);
+        H5Dclose(dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_multi_io(void)
+{
+    hsize_t     dims[1] = { DATASET_MULTI_IO_TEST_NUM_POINTS };
+    hsize_t     start[1] = { DATASET_MULTI_IO_TEST_NUM_POINTS / 2 };
+    hsize_t     count[1] = { DATASET_MULTI_IO_TEST_NUM_POINTS / 2 };
+    size_t      i, j;
+    herr_t      statuses[DATASET_MULTI_IO_TEST_NUM_DSETS];
+    hid_t       file_id = -1, fapl_id = -1;
+    hid_t       container_group = -1;
+    hid_t       dset_ids[DATASET_MULTI_IO_TEST_NUM_DSETS];
+    hid_t       mem_type_ids[DATASET_MULTI_IO_TEST_NUM_DSETS];
+    hid_t       mem_space_ids[DATASET_MULTI_IO_TEST_NUM_DSETS];
+    hid_t       file_space_ids[DATASET_MULTI_IO_TEST_NUM_DSETS];
+    hid_t       fspace_id = -1;
+    hid_t       sel_space_id = -1;
+    hid_t       mspace_id = -1;
+    char        dset_name[64];
+    int         data[DATASET_MULTI_IO_TEST_NUM_DSETS][DATASET_MULTI_IO_TEST_NUM_POINTS];
+    int         read_buf[DATASET_MULTI_IO_TEST_NUM_DSETS][DATASET_MULTI_IO_TEST_NUM_POINTS / 2];
+    const void *write_bufs[DATASET_MULTI_IO_TEST_NUM_DSETS];
+    void       *read_bufs[DATASET_MULTI_IO_TEST_NUM_DSETS];
+
+    TESTING("read from and write to multiple datasets")
+
+    for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++)
+        dset_ids[i] = -1;
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++) {
+        snprintf(dset_name, sizeof(dset_name), DATASET_MULTI_IO_TEST_DSET_PREFIX "%zu", i);
+
+        if ((dset_ids[i] = H5Dcreate2(container_group, dset_name, H5T_NATIVE_INT,
+                fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't create dataset '%s'\n", dset_name);
+            goto error;
+        }
+
+        for (j = 0; j < DATASET_MULTI_IO_TEST_NUM_POINTS; j++)
+            data[i][j] = (int) ((i * DATASET_MULTI_IO_TEST_NUM_POINTS) + j);
+
+        mem_type_ids[i] = H5T_NATIVE_INT;
+        mem_space_ids[i] = H5S_ALL;
+        file_space_ids[i] = H5S_ALL;
+        write_bufs[i] = data[i];
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Writing to all datasets at once\n");
+#endif
+
+    if (RVdataset_write_multi(DATASET_MULTI_IO_TEST_NUM_DSETS, dset_ids, mem_type_ids, mem_space_ids,
+            file_space_ids, H5P_DEFAULT, write_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to multiple datasets\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++)
+        if (statuses[i] < 0) {
+            H5_FAILED();
+            printf("    write to dataset %zu failed\n", i);
+            goto error;
+        }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Reading the second half of each dataset at once\n");
+#endif
+
+    if ((sel_space_id = H5Scopy(fspace_id)) < 0)
+        TEST_ERROR
+    if (H5Sselect_hyperslab(sel_space_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(1, count, NULL)) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++) {
+        mem_space_ids[i] = mspace_id;
+        file_space_ids[i] = sel_space_id;
+        read_bufs[i] = read_buf[i];
+    }
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (RVdataset_read_multi(DATASET_MULTI_IO_TEST_NUM_DSETS, dset_ids, mem_type_ids, mem_space_ids,
+            file_space_ids, H5P_DEFAULT, read_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from multiple datasets\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++) {
+        if (statuses[i] < 0) {
+            H5_FAILED();
+            printf("    read from dataset %zu failed\n", i);
+            goto error;
+        }
+
+        for (j = 0; j < count[0]; j++)
+            if (read_buf[i][j] != data[i][start[0] + j]) {
+                H5_FAILED();
+                printf("    data read from dataset %zu didn't match\n", i);
+                goto error;
+            }
+    }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(sel_space_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++)
+        if (H5Dclose(dset_ids[i]) < 0)
+            TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(sel_space_id);
+        H5Sclose(fspace_id);
+        for (i = 0; i < DATASET_MULTI_IO_TEST_NUM_DSETS; i++)
+            H5Dclose(dset_ids[i]);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_query(void)
+{
+    typedef struct {
+        double temp;
+        double pressure;
+    } query_test_elem_t;
+
+    rv_query_result_t  result = { 0, NULL, NULL };
+    query_test_elem_t  data[DATASET_QUERY_TEST_NUM_POINTS];
+    query_test_elem_t *values;
+    hsize_t            dims[1] = { DATASET_QUERY_TEST_NUM_POINTS };
+    size_t             i, expected_nmatches = 0;
+    hid_t              file_id = -1, fapl_id = -1;
+    hid_t              container_group = -1;
+    hid_t              dset_id = -1;
+    hid_t              dset_dtype = -1;
+    hid_t              fspace_id = -1;
+
+    TESTING("query dataset on server")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_dtype = H5Tcreate(H5T_COMPOUND, sizeof(query_test_elem_t))) < 0)
+        TEST_ERROR
+    if (H5Tinsert(dset_dtype, "temp", HOFFSET(query_test_elem_t, temp), H5T_NATIVE_DOUBLE) < 0)
+        TEST_ERROR
+    if (H5Tinsert(dset_dtype, "pressure", HOFFSET(query_test_elem_t, pressure), H5T_NATIVE_DOUBLE) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(container_group, DATASET_QUERY_TEST_DSET_NAME, dset_dtype,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_QUERY_TEST_NUM_POINTS; i++) {
+        data[i].temp = (double) (i * 10);
+        data[i].pressure = (double) (i % 20);
+
+        if (data[i].temp > 300 && data[i].pressure < 10)
+            expected_nmatches++;
+    }
+
+    if (H5Dwrite(dset_id, dset_dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (RVdataset_query(dset_id, DATASET_QUERY_TEST_QUERY, dset_dtype, H5P_DEFAULT, &result) < 0) {
+        H5_FAILED();
+        printf("    couldn't query dataset\n");
+        goto error;
+    }
+
+    if (result.nmatches != expected_nmatches) {
+        H5_FAILED();
+        printf("    query matched %zu elements instead of %zu\n", result.nmatches, expected_nmatches);
+        goto error;
+    }
+
+    values = (query_test_elem_t *) result.values;
+
+    for (i = 0; i < result.nmatches; i++) {
+        hsize_t idx = result.indices[i];
+
+        if (idx >= DATASET_QUERY_TEST_NUM_POINTS
+                || (i > 0 && idx <= result.indices[i - 1])
+                || !(data[idx].temp > 300 && data[idx].pressure < 10)) {
+            H5_FAILED();
+            printf("    query returned wrong element index %llu\n", (unsigned long long) idx);
+            goto error;
+        }
+
+        if (values[i].temp != data[idx].temp || values[i].pressure != data[idx].pressure) {
+            H5_FAILED();
+            printf("    value of element %llu returned by query didn't match\n", (unsigned long long) idx);
+            goto error;
+        }
+    }
+
+    if (RVquery_result_free(&result) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Tclose(dset_dtype) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        RVquery_result_free(&result);
+        H5Sclose(fspace_id);
+        H5Tclose(dset_dtype);
+        H5Dclose(dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_disk_cache(void)
+{
+    hsize_t dims[1] = { DATASET_DISK_CACHE_TEST_NUM_POINTS };
+    hsize_t start[1] = { DATASET_DISK_CACHE_TEST_NUM_POINTS / 4 };
+    hsize_t count[1] = { DATASET_DISK_CACHE_TEST_NUM_POINTS / 2 };
+    size_t  max_size;
+    size_t  i, j;
+    hid_t   file_id = -1, fapl_id = -1;
+    hid_t   container_group = -1;
+    hid_t   dset_id = -1, dset_id2 = -1;
+    hid_t   fspace_id = -1;
+    hid_t   mspace_id = -1;
+    char    cache_dir[sizeof(DATASET_DISK_CACHE_TEST_DIR)];
+    int     data[DATASET_DISK_CACHE_TEST_NUM_POINTS];
+    int     read_buf[DATASET_DISK_CACHE_TEST_NUM_POINTS / 2];
+#ifndef WIN32
+    rv_stats_t stats;
+    size_t     num_reads = 0;
+#endif
+
+    TESTING("dataset reads through disk cache")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_disk_cache(fapl_id, DATASET_DISK_CACHE_TEST_DIR, DATASET_DISK_CACHE_TEST_MAX_SIZE) < 0)
+        TEST_ERROR
+    if (H5Pget_fapl_rest_vol_disk_cache(fapl_id, cache_dir, sizeof(cache_dir), &max_size) < 0)
+        TEST_ERROR
+
+    if (strcmp(cache_dir, DATASET_DISK_CACHE_TEST_DIR) || max_size != DATASET_DISK_CACHE_TEST_MAX_SIZE) {
+        H5_FAILED();
+        printf("    disk cache settings retrieved from FAPL didn't match\n");
+        goto error;
+    }
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(container_group, DATASET_DISK_CACHE_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_DISK_CACHE_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+
+    /* Reopen the dataset so that its modification time is known and reads can be cached */
+    if ((dset_id = H5Dopen2(container_group, DATASET_DISK_CACHE_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    if (H5Sselect_hyperslab(fspace_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(1, count, NULL)) < 0)
+        TEST_ERROR
+
+    /* Open a second handle to the dataset, which is used to check that a write
+     * through the first handle stops reads through it from using the disk cache
+     */
+    if ((dset_id2 = H5Dopen2(container_group, DATASET_DISK_CACHE_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    /* The first read populates the disk cache. The second read, and the read
+     * through the second handle, are served from it without going to the server.
+     */
+    for (i = 0; i < 3; i++) {
+        memset(read_buf, 0, sizeof(read_buf));
+
+        if (H5Dread(i < 2 ? dset_id : dset_id2, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, read_buf) < 0) {
+            H5_FAILED();
+            printf("    couldn't read from dataset\n");
+            goto error;
+        }
+
+        for (j = 0; j < count[0]; j++)
+            if (read_buf[j] != data[start[0] + j]) {
+                H5_FAILED();
+                printf("    data read from dataset on pass %zu didn't match\n", i);
+                goto error;
+            }
+
+#ifndef WIN32
+        if (RVget_stats(&stats) < 0)
+            TEST_ERROR
+
+        if (!i)
+            num_reads = stats.requests[RV_REQUEST_DATASET_VALUE_GET].num_requests;
+        else if (stats.requests[RV_REQUEST_DATASET_VALUE_GET].num_requests != num_reads) {
+            H5_FAILED();
+            printf("    read on pass %zu wasn't served from the disk cache\n", i);
+            goto error;
+        }
+#endif
+    }
+
+    /* Overwrite the dataset through the first handle */
+    for (i = 0; i < DATASET_DISK_CACHE_TEST_NUM_POINTS; i++)
+        data[i] = -(int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id2, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    for (j = 0; j < count[0]; j++)
+        if (read_buf[j] != data[start[0] + j]) {
+            H5_FAILED();
+            printf("    stale data was read from the disk cache after the dataset was written to\n");
+            goto error;
+        }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id2) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    if (remove_disk_cache_dir(DATASET_DISK_CACHE_TEST_DIR) < 0) {
+        H5_FAILED();
+        printf("    couldn't remove disk cache directory\n");
+        goto error;
+    }
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Dclose(dset_id2);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    remove_disk_cache_dir(DATASET_DISK_CACHE_TEST_DIR);
+
+    return 1;
+}
+
+static int
+test_dataset_request_stats(void)
+{
+    const rv_request_stats_t *get_stats, *put_stats;
+    rv_stats_t                stats;
+    hsize_t                   dims[1] = { DATASET_REQUEST_STATS_TEST_NUM_POINTS };
+    size_t                    i;
+    hid_t                     file_id = -1, fapl_id = -1;
+    hid_t                     container_group = -1;
+    hid_t                     dset_id = -1;
+    hid_t                     fspace_id = -1;
+    int                       data[DATASET_REQUEST_STATS_TEST_NUM_POINTS];
+    int                       read_buf[DATASET_REQUEST_STATS_TEST_NUM_POINTS];
+
+    TESTING("request statistics for dataset I/O")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(container_group, DATASET_REQUEST_STATS_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_REQUEST_STATS_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (RVreset_stats() < 0)
+        TEST_ERROR
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    if (RVget_stats(&stats) < 0)
+        TEST_ERROR
+
+    put_stats = &stats.requests[RV_REQUEST_DATASET_VALUE_PUT];
+    get_stats = &stats.requests[RV_REQUEST_DATASET_VALUE_GET];
+
+    if (!put_stats->num_requests || !put_stats->num_status[1] || !put_stats->bytes_sent) {
+        H5_FAILED();
+        printf("    dataset write wasn't recorded in request statistics\n");
+        goto error;
+    }
+
+    if (!get_stats->num_requests || !get_stats->num_status[1]
+            || get_stats->bytes_received < sizeof(read_buf)) {
+        H5_FAILED();
+        printf("    dataset read wasn't recorded in request statistics\n");
+        goto error;
+    }
+
+    if (RVstats_latency_percentile(get_stats, 100.0) > get_stats->max_latency_us) {
+        H5_FAILED();
+        printf("    latency percentile was larger than maximum latency\n");
+        goto error;
+    }
+
+    if (RVreset_stats() < 0)
+        TEST_ERROR
+    if (RVget_stats(&stats) < 0)
+        TEST_ERROR
+
+    if (stats.requests[RV_REQUEST_DATASET_VALUE_GET].num_requests) {
+        H5_FAILED();
+        printf("    request statistics weren't reset\n");
+        goto error;
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+#ifndef WIN32
+static int
+test_dataset_endpoints(void)
+{
+    rv_mock_hsds_faults_t faults;
+    rv_mock_hsds_stats_t  before[DATASET_ENDPOINTS_TEST_NUM_PORTS], after[DATASET_ENDPOINTS_TEST_NUM_PORTS];
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        ports[DATASET_ENDPOINTS_TEST_NUM_PORTS];
+    rv_stats_t            stats;
+    hsize_t               dims[1] = { DATASET_ENDPOINTS_TEST_NUM_POINTS };
+    size_t                i, j, k;
+    size_t                hash_port = 0;
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_id = -1;
+    hid_t                 fspace_id = -1;
+    hid_t                 dxpl_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    int                   data[DATASET_ENDPOINTS_TEST_NUM_POINTS];
+    int                   read_buf[DATASET_ENDPOINTS_TEST_NUM_POINTS];
+
+    TESTING("dataset I/O spread over several endpoints")
+
+    if (NULL == (server = start_mock_server(NULL, DATASET_ENDPOINTS_TEST_NUM_PORTS, ports, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    memset(&faults, 0, sizeof(faults));
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+    if (H5Pset_dxpl_rest_vol_retry(dxpl_id, DATASET_ENDPOINTS_TEST_MAX_RETRIES, 0.0, 0.0) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_ENDPOINTS_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++) {
+        if (rv_mock_hsds_get_port_stats(server, ports[i], &before[i]) < 0)
+            TEST_ERROR
+
+        if (!before[i].num_requests) {
+            H5_FAILED();
+            printf("    requests weren't spread over every endpoint\n");
+            goto error;
+        }
+    }
+
+    /* Make the second endpoint fail. Its requests should be retried on the first
+     * one until it has failed often enough to be left out altogether.
+     */
+    faults.fail_count = UINT32_MAX;
+    if (rv_mock_hsds_set_faults(server, ports[1], &faults) < 0)
+        TEST_ERROR
+
+    if (RVreset_stats() < 0)
+        TEST_ERROR
+
+    for (k = 0; k < 2; k++) {
+        for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++)
+            if (rv_mock_hsds_get_port_stats(server, ports[i], &before[i]) < 0)
+                TEST_ERROR
+
+        for (j = 0; j < DATASET_ENDPOINTS_TEST_NUM_READS; j++) {
+            memset(read_buf, 0, sizeof(read_buf));
+
+            if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, read_buf) < 0) {
+                H5_FAILED();
+                printf("    couldn't read from dataset with one endpoint failing\n");
+                goto error;
+            }
+
+            for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_POINTS; i++)
+                if (read_buf[i] != data[i]) {
+                    H5_FAILED();
+                    printf("    wrong data read with one endpoint failing\n");
+                    goto error;
+                }
+        }
+
+        for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++)
+            if (rv_mock_hsds_get_port_stats(server, ports[i], &after[i]) < 0)
+                TEST_ERROR
+
+        if (after[0].num_requests - before[0].num_requests < DATASET_ENDPOINTS_TEST_NUM_READS) {
+            H5_FAILED();
+            printf("    requests weren't moved to the healthy endpoint\n");
+            goto error;
+        }
+
+        /* By the second round of reads, the failing endpoint should have been ejected */
+        if (k && after[1].num_requests != before[1].num_requests) {
+            H5_FAILED();
+            printf("    requests were still sent to the failing endpoint\n");
+            goto error;
+        }
+    }
+
+    if (RVget_stats(&stats) < 0)
+        TEST_ERROR
+
+    if (!stats.num_retries) {
+        H5_FAILED();
+        printf("    requests to the failing endpoint weren't retried\n");
+        goto error;
+    }
+
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    /* Under the hash policy, the requests for the dataset's values should all
+     * go to the same endpoint, each time the dataset is opened
+     */
+    faults.fail_count = 0;
+    if (rv_mock_hsds_set_faults(server, 0, &faults) < 0)
+        TEST_ERROR
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_HASH) < 0)
+        TEST_ERROR
+
+    if ((dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+    if (H5Pset_dxpl_rest_vol_retry(dxpl_id, DATASET_ENDPOINTS_TEST_MAX_RETRIES, 0.0, 0.0) < 0)
+        TEST_ERROR
+
+    for (k = 0; k < 2; k++) {
+        size_t port = DATASET_ENDPOINTS_TEST_NUM_PORTS;
+
+        if (k) {
+            if (H5Dclose(dset_id) < 0)
+                TEST_ERROR
+            if (H5Fclose(file_id) < 0)
+                TEST_ERROR
+        }
+
+        if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+            H5_FAILED();
+            printf("    couldn't open file\n");
+            goto error;
+        }
+
+        if ((dset_id = H5Dopen2(file_id, DATASET_ENDPOINTS_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't open dataset\n");
+            goto error;
+        }
+
+        for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++)
+            if (rv_mock_hsds_get_port_stats(server, ports[i], &before[i]) < 0)
+                TEST_ERROR
+
+        for (j = 0; j < DATASET_ENDPOINTS_TEST_NUM_READS; j++)
+            if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, read_buf) < 0) {
+                H5_FAILED();
+                printf("    couldn't read from dataset\n");
+                goto error;
+            }
+
+        for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++) {
+            if (rv_mock_hsds_get_port_stats(server, ports[i], &after[i]) < 0)
+                TEST_ERROR
+
+            if (after[i].num_requests == before[i].num_requests)
+                continue;
+
+            if (port < DATASET_ENDPOINTS_TEST_NUM_PORTS) {
+                H5_FAILED();
+                printf("    requests for one dataset were spread over several endpoints under the hash policy\n");
+                goto error;
+            }
+
+            port = i;
+        }
+
+        if (k && port != hash_port) {
+            H5_FAILED();
+            printf("    dataset moved to a different endpoint when it was reopened\n");
+            goto error;
+        }
+
+        hash_port = port;
+    }
+
+    /* Make the dataset's endpoint fail; its requests should move to the other
+     * endpoint once it has been ejected
+     */
+    faults.fail_count = UINT32_MAX;
+    if (rv_mock_hsds_set_faults(server, ports[hash_port], &faults) < 0)
+        TEST_ERROR
+
+    for (k = 0; k < 2; k++) {
+        for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++)
+            if (rv_mock_hsds_get_port_stats(server, ports[i], &before[i]) < 0)
+                TEST_ERROR
+
+        for (j = 0; j < DATASET_ENDPOINTS_TEST_NUM_READS; j++) {
+            memset(read_buf, 0, sizeof(read_buf));
+
+            if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, read_buf) < 0) {
+                H5_FAILED();
+                printf("    couldn't read from dataset with its endpoint failing\n");
+                goto error;
+            }
+
+            for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_POINTS; i++)
+                if (read_buf[i] != data[i]) {
+                    H5_FAILED();
+                    printf("    wrong data read with the dataset's endpoint failing\n");
+                    goto error;
+                }
+        }
+
+        for (i = 0; i < DATASET_ENDPOINTS_TEST_NUM_PORTS; i++)
+            if (rv_mock_hsds_get_port_stats(server, ports[i], &after[i]) < 0)
+                TEST_ERROR
+
+        if (k && after[hash_port].num_requests != before[hash_port].num_requests) {
+            H5_FAILED();
+            printf("    requests were still sent to the failing endpoint under the hash policy\n");
+            goto error;
+        }
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(dxpl_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_compression(void)
+{
+#ifdef RV_HAVE_ZLIB
+    rv_mock_hsds_config_t config;
+    rv_mock_hsds_faults_t faults;
+    rv_mock_hsds_stats_t  before, after;
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        port;
+    hsize_t               dims[1] = { DATASET_COMPRESSION_TEST_NUM_POINTS };
+    size_t                i, j;
+    herr_t                err_ret = -1;
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_id = -1;
+    hid_t                 fspace_id = -1;
+    hid_t                 dxpl_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    int                   data[DATASET_COMPRESSION_TEST_NUM_POINTS];
+    int                   read_buf[DATASET_COMPRESSION_TEST_NUM_POINTS];
+#endif
+
+    TESTING("dataset I/O compressed in transit")
+
+#ifdef RV_HAVE_ZLIB
+    memset(&config, 0, sizeof(config));
+    config.compress_values = 1;
+
+    if (NULL == (server = start_mock_server(&config, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    memset(&faults, 0, sizeof(faults));
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+    if (H5Pset_dxpl_rest_vol_compression(dxpl_id, RV_COMPRESSION_DEFLATE, TRUE, 0) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_COMPRESSION_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_COMPRESSION_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (rv_mock_hsds_get_port_stats(server, port, &before) < 0)
+        TEST_ERROR
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset with compression\n");
+        goto error;
+    }
+
+    if (rv_mock_hsds_get_port_stats(server, port, &after) < 0)
+        TEST_ERROR
+
+    if (after.bytes_received - before.bytes_received >= sizeof(data)) {
+        H5_FAILED();
+        printf("    write data wasn't compressed\n");
+        goto error;
+    }
+
+    /* Read the data back both with compression requested, where the plugin
+     * decodes the data itself, and without, where cURL decodes it
+     */
+    for (j = 0; j < 2; j++) {
+        memset(read_buf, 0, sizeof(read_buf));
+
+        if (rv_mock_hsds_get_port_stats(server, port, &before) < 0)
+            TEST_ERROR
+
+        if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, j ? H5P_DEFAULT : dxpl_id, read_buf) < 0) {
+            H5_FAILED();
+            printf("    couldn't read from dataset %s compression\n", j ? "without" : "with");
+            goto error;
+        }
+
+        if (rv_mock_hsds_get_port_stats(server, port, &after) < 0)
+            TEST_ERROR
+
+        if (!j && after.bytes_sent - before.bytes_sent >= sizeof(read_buf)) {
+            H5_FAILED();
+            printf("    read data wasn't compressed\n");
+            goto error;
+        }
+
+        for (i = 0; i < DATASET_COMPRESSION_TEST_NUM_POINTS; i++)
+            if (read_buf[i] != data[i]) {
+                H5_FAILED();
+                printf("    wrong data read %s compression\n", j ? "without" : "with");
+                goto error;
+            }
+    }
+
+    /* A response in a content encoding the plugin doesn't know must make the
+     * read fail rather than return the undecoded data
+     */
+    faults.content_encoding = DATASET_COMPRESSION_TEST_BAD_CODING;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    H5E_BEGIN_TRY {
+        err_ret = H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, read_buf);
+    } H5E_END_TRY;
+
+    if (err_ret >= 0) {
+        H5_FAILED();
+        printf("    read succeeded despite an unknown content encoding\n");
+        goto error;
+    }
+
+    faults.content_encoding = NULL;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+#else
+    SKIPPED();
+#endif
+
+    return 0;
+
+#ifdef RV_HAVE_ZLIB
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(dxpl_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+#endif
+}
+
+static int
+test_dataset_retry(void)
+{
+    rv_mock_hsds_faults_t faults;
+    rv_mock_hsds_t       *server = NULL;
+    struct timeval        start, end;
+    unsigned short        port;
+    rv_stats_t            stats;
+    hsize_t               dims[1] = { DATASET_RETRY_TEST_NUM_POINTS };
+    size_t                i;
+    double                elapsed;
+    herr_t                err_ret = -1;
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_id = -1;
+    hid_t                 fspace_id = -1;
+    hid_t                 dxpl_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    int                   data[DATASET_RETRY_TEST_NUM_POINTS];
+    int                   read_buf[DATASET_RETRY_TEST_NUM_POINTS];
+
+    TESTING("dataset I/O retried on server errors and bounded by a deadline")
+
+    if (NULL == (server = start_mock_server(NULL, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    memset(&faults, 0, sizeof(faults));
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_RETRY_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_RETRY_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (RVreset_stats() < 0)
+        TEST_ERROR
+
+    /* Have the server answer the first attempt at both the write and the read
+     * with a 503, which should be retried transparently
+     */
+    faults.fail_count = 1;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset after a 503 response\n");
+        goto error;
+    }
+
+    faults.fail_count = 1;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset after a 503 response\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_RETRY_TEST_NUM_POINTS; i++)
+        if (read_buf[i] != data[i]) {
+            H5_FAILED();
+            printf("    wrong data read after a 503 response\n");
+            goto error;
+        }
+
+    if (RVget_stats(&stats) < 0)
+        TEST_ERROR
+
+    if (stats.num_retries < 2) {
+        H5_FAILED();
+        printf("    %llu requests were retried, expected at least 2\n", (unsigned long long) stats.num_retries);
+        goto error;
+    }
+
+    /* A server that stalls for longer than the deadline must make the read
+     * fail once the deadline passes rather than wait for the server
+     */
+    if ((dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+    if (H5Pset_dxpl_rest_vol_deadline(dxpl_id, DATASET_RETRY_TEST_DEADLINE) < 0)
+        TEST_ERROR
+
+    faults.fail_count = 0;
+    faults.delay_us = DATASET_RETRY_TEST_STALL_US;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    gettimeofday(&start, NULL);
+
+    H5E_BEGIN_TRY {
+        err_ret = H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, read_buf);
+    } H5E_END_TRY;
+
+    gettimeofday(&end, NULL);
+
+    elapsed = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_usec - start.tv_usec) / 1e6;
+
+    if (err_ret >= 0) {
+        H5_FAILED();
+        printf("    read succeeded despite the server stalling past the deadline\n");
+        goto error;
+    }
+
+    if (elapsed >= (double) DATASET_RETRY_TEST_STALL_US / 1e6) {
+        H5_FAILED();
+        printf("    read took %.2f seconds to fail, past its deadline of %.2f seconds\n", elapsed,
+                DATASET_RETRY_TEST_DEADLINE);
+        goto error;
+    }
+
+    faults.delay_us = 0;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(dxpl_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_truncated_read(void)
+{
+    rv_mock_hsds_faults_t faults;
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        port;
+    rv_stats_t            stats;
+    hsize_t               dims[1] = { DATASET_TRUNCATED_READ_TEST_NUM_POINTS };
+    uint64_t              num_reads;
+    size_t                i;
+    herr_t                err_ret = -1;
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_id = -1;
+    hid_t                 fspace_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    int                   data[DATASET_TRUNCATED_READ_TEST_NUM_POINTS];
+    int                   read_buf[DATASET_TRUNCATED_READ_TEST_NUM_POINTS];
+
+    TESTING("dataset read of truncated data from server")
+
+    if (NULL == (server = start_mock_server(NULL, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    memset(&faults, 0, sizeof(faults));
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_disk_cache(fapl_id, DATASET_TRUNCATED_READ_TEST_DIR,
+            DATASET_TRUNCATED_READ_TEST_MAX_SIZE) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_TRUNCATED_READ_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_TRUNCATED_READ_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+
+    /* Reopen the dataset so that its modification time is known and reads can be cached */
+    if ((dset_id = H5Dopen2(file_id, DATASET_TRUNCATED_READ_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    /* A read which gets back less data than was selected must fail rather
+     * than leave part of the read buffer untouched
+     */
+    faults.truncate_len = sizeof(int);
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    H5E_BEGIN_TRY {
+        err_ret = H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf);
+    } H5E_END_TRY;
+
+    if (err_ret >= 0) {
+        H5_FAILED();
+        printf("    read succeeded despite the server sending back truncated data\n");
+        goto error;
+    }
+
+    faults.truncate_len = 0;
+    if (rv_mock_hsds_set_faults(server, port, &faults) < 0)
+        TEST_ERROR
+
+    /* The truncated data mustn't have been kept in the disk cache, so the
+     * next read goes to the server and the one after that to the cache
+     */
+    for (i = 0; i < 2; i++) {
+        if (RVget_stats(&stats) < 0)
+            TEST_ERROR
+        num_reads = stats.requests[RV_REQUEST_DATASET_VALUE_GET].num_requests;
+
+        memset(read_buf, 0, sizeof(read_buf));
+
+        if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+            H5_FAILED();
+            printf("    couldn't read from dataset\n");
+            goto error;
+        }
+
+        if (memcmp(read_buf, data, sizeof(data))) {
+            H5_FAILED();
+            printf("    data read from dataset on pass %zu didn't match\n", i);
+            goto error;
+        }
+
+        if (RVget_stats(&stats) < 0)
+            TEST_ERROR
+
+        if ((stats.requests[RV_REQUEST_DATASET_VALUE_GET].num_requests != num_reads) != !i) {
+            H5_FAILED();
+            printf("    read on pass %zu was %s the disk cache\n", i, i ? "not served from" : "served from");
+            goto error;
+        }
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+    server = NULL;
+
+    if (remove_disk_cache_dir(DATASET_TRUNCATED_READ_TEST_DIR) < 0) {
+        H5_FAILED();
+        printf("    couldn't remove disk cache directory\n");
+        goto error;
+    }
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    remove_disk_cache_dir(DATASET_TRUNCATED_READ_TEST_DIR);
+
+    return 1;
+}
+
+static int
+test_dataset_priority(void)
+{
+    rv_mock_hsds_config_t config;
+    rv_mock_hsds_stats_t  stats;
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        port;
+    hsize_t               dims[1];
+    size_t                npoints[DATASET_PRIORITY_TEST_NUM_DSETS];
+    size_t                i, j, k;
+    herr_t                statuses[DATASET_PRIORITY_TEST_NUM_DSETS];
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_ids[DATASET_PRIORITY_TEST_NUM_DSETS];
+    hid_t                 mem_type_ids[DATASET_PRIORITY_TEST_NUM_DSETS];
+    hid_t                 space_ids[DATASET_PRIORITY_TEST_NUM_DSETS];
+    hid_t                 fspace_id = -1;
+    hid_t                 dxpl_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    char                  dset_name[64];
+    const void           *write_bufs[DATASET_PRIORITY_TEST_NUM_DSETS];
+    void                 *read_bufs[DATASET_PRIORITY_TEST_NUM_DSETS];
+    int                  *data[DATASET_PRIORITY_TEST_NUM_DSETS];
+    int                  *read_data[DATASET_PRIORITY_TEST_NUM_DSETS];
+
+    TESTING("dataset transfers of mixed priority classes")
+
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+        dset_ids[i] = -1;
+        data[i] = NULL;
+        read_data[i] = NULL;
+    }
+
+    /* The server's latency makes the concurrent requests overlap at the server */
+    memset(&config, 0, sizeof(config));
+    config.latency_us = DATASET_PRIORITY_TEST_LATENCY_US;
+
+    if (NULL == (server = start_mock_server(&config, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    /* The first datasets are large enough to be bulk transfers and the rest are small */
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+        npoints[i] = (i < DATASET_PRIORITY_TEST_NUM_BULK) ? DATASET_PRIORITY_TEST_BULK_POINTS
+                                                          : DATASET_PRIORITY_TEST_SMALL_POINTS;
+
+        if (NULL == (data[i] = (int *) malloc(npoints[i] * sizeof(int))))
+            TEST_ERROR
+        if (NULL == (read_data[i] = (int *) malloc(npoints[i] * sizeof(int))))
+            TEST_ERROR
+
+        for (j = 0; j < npoints[i]; j++)
+            data[i][j] = (int) (i * DATASET_PRIORITY_TEST_BULK_POINTS + j);
+
+        mem_type_ids[i] = H5T_NATIVE_INT;
+        space_ids[i] = H5S_ALL;
+        write_bufs[i] = data[i];
+        read_bufs[i] = read_data[i];
+    }
+
+    /* With room for only one bulk request at a time, the bulk transfers must
+     * be made one after another
+     */
+    if (setenv("HSDS_MAX_BULK_REQUESTS", "1", 1) < 0)
+        TEST_ERROR
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+        dims[0] = (hsize_t) npoints[i];
+
+        if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+            TEST_ERROR
+
+        snprintf(dset_name, sizeof(dset_name), DATASET_PRIORITY_TEST_DSET_PREFIX "%zu", i);
+
+        if ((dset_ids[i] = H5Dcreate2(file_id, dset_name, H5T_NATIVE_INT, fspace_id,
+                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't create dataset '%s'\n", dset_name);
+            goto error;
+        }
+
+        if (H5Sclose(fspace_id) < 0)
+            TEST_ERROR
+        fspace_id = -1;
+    }
+
+    if (RVdataset_write_multi(DATASET_PRIORITY_TEST_NUM_BULK, dset_ids, mem_type_ids, space_ids, space_ids,
+            H5P_DEFAULT, write_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to the bulk datasets\n");
+        goto error;
+    }
+
+    if (RVdataset_read_multi(DATASET_PRIORITY_TEST_NUM_BULK, dset_ids, mem_type_ids, space_ids, space_ids,
+            H5P_DEFAULT, read_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from the bulk datasets\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_BULK; i++)
+        if (statuses[i] < 0 || memcmp(read_data[i], data[i], npoints[i] * sizeof(int))) {
+            H5_FAILED();
+            printf("    read from bulk dataset %zu failed\n", i);
+            goto error;
+        }
+
+    if (rv_mock_hsds_get_stats(server, &stats) < 0)
+        TEST_ERROR
+
+    if (stats.max_requests_in_flight != 1) {
+        H5_FAILED();
+        printf("    %llu requests were in flight at once with HSDS_MAX_BULK_REQUESTS=1\n",
+                (unsigned long long) stats.max_requests_in_flight);
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+        if (H5Dclose(dset_ids[i]) < 0)
+            TEST_ERROR
+        dset_ids[i] = -1;
+    }
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    if (unsetenv("HSDS_MAX_BULK_REQUESTS") < 0)
+        TEST_ERROR
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+        snprintf(dset_name, sizeof(dset_name), DATASET_PRIORITY_TEST_DSET_PREFIX "%zu", i);
+
+        if ((dset_ids[i] = H5Dopen2(file_id, dset_name, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't open dataset '%s'\n", dset_name);
+            goto error;
+        }
+    }
+
+    if (RVdataset_write_multi(DATASET_PRIORITY_TEST_NUM_DSETS - DATASET_PRIORITY_TEST_NUM_BULK,
+            dset_ids + DATASET_PRIORITY_TEST_NUM_BULK, mem_type_ids, space_ids, space_ids, H5P_DEFAULT,
+            write_bufs + DATASET_PRIORITY_TEST_NUM_BULK, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to the small datasets\n");
+        goto error;
+    }
+
+    /* Read every dataset at once, first with the bulk and small transfers
+     * competing and then with the whole read marked as interactive. Every
+     * transfer should complete in both cases.
+     */
+    if ((dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+
+    for (k = 0; k < 2; k++) {
+        if (k && H5Pset_dxpl_rest_vol_priority(dxpl_id, RV_PRIORITY_INTERACTIVE) < 0)
+            TEST_ERROR
+
+        for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+            memset(read_data[i], 0, npoints[i] * sizeof(int));
+            statuses[i] = -1;
+        }
+
+        if (RVdataset_read_multi(DATASET_PRIORITY_TEST_NUM_DSETS, dset_ids, mem_type_ids, space_ids, space_ids,
+                dxpl_id, read_bufs, statuses) < 0) {
+            H5_FAILED();
+            printf("    couldn't read from the datasets %s\n", k ? "as interactive transfers" : "by size class");
+            goto error;
+        }
+
+        for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++)
+            if (statuses[i] < 0 || memcmp(read_data[i], data[i], npoints[i] * sizeof(int))) {
+                H5_FAILED();
+                printf("    read from dataset %zu failed %s\n", i, k ? "as an interactive transfer" : "by size class");
+                goto error;
+            }
+    }
+
+    /* Without the limit, the transfers should have overlapped */
+    if (rv_mock_hsds_get_stats(server, &stats) < 0)
+        TEST_ERROR
+
+    if (stats.max_requests_in_flight < 2) {
+        H5_FAILED();
+        printf("    concurrent transfers were never in flight at once\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+        if (H5Dclose(dset_ids[i]) < 0)
+            TEST_ERROR
+        free(data[i]);
+        free(read_data[i]);
+    }
+    if (H5Pclose(dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    unsetenv("HSDS_MAX_BULK_REQUESTS");
+
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        for (i = 0; i < DATASET_PRIORITY_TEST_NUM_DSETS; i++) {
+            H5Dclose(dset_ids[i]);
+            free(data[i]);
+            free(read_data[i]);
+        }
+        H5Pclose(dxpl_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_priority_starvation(void)
+{
+    rv_mock_hsds_config_t config;
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        port;
+    hsize_t               dims[1];
+    size_t                npoints[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    size_t                num_bulk_done = 0;
+    size_t                i, j;
+    herr_t                statuses[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_ids[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    hid_t                 mem_type_ids[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    hid_t                 space_ids[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    hid_t                 fspace_id = -1;
+    FILE                 *trace_file = NULL;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    char                  dset_name[64];
+    char                 *trace = NULL;
+    char                 *event, *event_end;
+    const char           *bytes;
+    const void           *write_bufs[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    void                 *read_bufs[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    int                  *data[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    int                  *read_data[DATASET_STARVATION_TEST_NUM_BULK + 1];
+    int                   small_done = 0;
+    long                  trace_len;
+
+    TESTING("small dataset transfer alongside queued bulk transfers")
+
+    for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++) {
+        dset_ids[i] = -1;
+        data[i] = NULL;
+        read_data[i] = NULL;
+    }
+
+    /* The server's latency makes each request take long enough for the
+     * order in which they complete to show how they were scheduled
+     */
+    memset(&config, 0, sizeof(config));
+    config.latency_us = DATASET_STARVATION_TEST_LATENCY_US;
+
+    if (NULL == (server = start_mock_server(&config, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    /* The small dataset comes after all of the bulk ones, so it would be
+     * started last if the transfers were started in order
+     */
+    for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++) {
+        npoints[i] = (i < DATASET_STARVATION_TEST_NUM_BULK) ? DATASET_STARVATION_TEST_BULK_POINTS
+                                                            : DATASET_STARVATION_TEST_SMALL_POINTS;
+
+        if (NULL == (data[i] = (int *) malloc(npoints[i] * sizeof(int))))
+            TEST_ERROR
+        if (NULL == (read_data[i] = (int *) malloc(npoints[i] * sizeof(int))))
+            TEST_ERROR
+
+        for (j = 0; j < npoints[i]; j++)
+            data[i][j] = (int) (i * DATASET_STARVATION_TEST_BULK_POINTS + j);
+
+        mem_type_ids[i] = H5T_NATIVE_INT;
+        space_ids[i] = H5S_ALL;
+        write_bufs[i] = data[i];
+        read_bufs[i] = read_data[i];
+    }
+
+    /* With room for only one bulk request at a time, the bulk transfers are
+     * queued one behind another
+     */
+    if (setenv("HSDS_MAX_BULK_REQUESTS", "1", 1) < 0)
+        TEST_ERROR
+    if (setenv("HSDS_TRACE_FILE", DATASET_STARVATION_TEST_FILE, 1) < 0)
+        TEST_ERROR
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++) {
+        dims[0] = (hsize_t) npoints[i];
+
+        if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+            TEST_ERROR
+
+        snprintf(dset_name, sizeof(dset_name), DATASET_STARVATION_TEST_DSET_PREFIX "%zu", i);
+
+        if ((dset_ids[i] = H5Dcreate2(file_id, dset_name, H5T_NATIVE_INT, fspace_id,
+                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't create dataset '%s'\n", dset_name);
+            goto error;
+        }
+
+        if (H5Sclose(fspace_id) < 0)
+            TEST_ERROR
+        fspace_id = -1;
+    }
+
+    if (RVdataset_write_multi(DATASET_STARVATION_TEST_NUM_BULK + 1, dset_ids, mem_type_ids, space_ids, space_ids,
+            H5P_DEFAULT, write_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to the datasets\n");
+        goto error;
+    }
+
+    if (RVdataset_read_multi(DATASET_STARVATION_TEST_NUM_BULK + 1, dset_ids, mem_type_ids, space_ids, space_ids,
+            H5P_DEFAULT, read_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from the datasets\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++)
+        if (statuses[i] < 0 || memcmp(read_data[i], data[i], npoints[i] * sizeof(int))) {
+            H5_FAILED();
+            printf("    read from dataset %zu failed\n", i);
+            goto error;
+        }
+
+    for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++) {
+        if (H5Dclose(dset_ids[i]) < 0)
+            TEST_ERROR
+        dset_ids[i] = -1;
+    }
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (unsetenv("HSDS_TRACE_FILE") < 0)
+        TEST_ERROR
+    if (unsetenv("HSDS_MAX_BULK_REQUESTS") < 0)
+        TEST_ERROR
+
+    /* Requests are traced in the order that they complete */
+    if (NULL == (trace_file = fopen(DATASET_STARVATION_TEST_FILE, "r"))) {
+        H5_FAILED();
+        printf("    trace file wasn't written\n");
+        goto error;
+    }
+
+    if (fseek(trace_file, 0, SEEK_END) < 0 || (trace_len = ftell(trace_file)) < 0 || fseek(trace_file, 0, SEEK_SET) < 0)
+        TEST_ERROR
+    if (NULL == (trace = (char *) malloc((size_t) trace_len + 1)))
+        TEST_ERROR
+    if (fread(trace, 1, (size_t) trace_len, trace_file) != (size_t) trace_len)
+        TEST_ERROR
+    trace[trace_len] = '\0';
+
+    fclose(trace_file);
+    trace_file = NULL;
+
+    /* The read of the small dataset should have completed before the second
+     * bulk read, rather than waiting for a turn behind the bulk reads
+     */
+    for (event = strchr(trace, '\n'); event; event = event_end) {
+        event++;
+        if (NULL != (event_end = strchr(event, '\n')))
+            *event_end = '\0';
+
+        if (!strstr(event, "\"name\": \"GET\"") || !strstr(event, "/value\"")
+                || NULL == (bytes = strstr(event, "\"bytes_received\": ")))
+            continue;
+
+        if (strtoull(bytes + strlen("\"bytes_received\": "), NULL, 10)
+                >= DATASET_STARVATION_TEST_BULK_POINTS * sizeof(int))
+            num_bulk_done++;
+        else {
+            small_done = 1;
+            break;
+        }
+    }
+
+    if (!small_done) {
+        H5_FAILED();
+        printf("    trace is missing the read of the small dataset\n");
+        goto error;
+    }
+
+    if (num_bulk_done > 1) {
+        H5_FAILED();
+        printf("    the small dataset read completed after %zu of the %d bulk reads\n",
+                num_bulk_done, DATASET_STARVATION_TEST_NUM_BULK);
+        goto error;
+    }
+
+    free(trace);
+    trace = NULL;
+
+    for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++) {
+        free(data[i]);
+        free(read_data[i]);
+    }
+
+    if (remove(DATASET_STARVATION_TEST_FILE) < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    unsetenv("HSDS_MAX_BULK_REQUESTS");
+    unsetenv("HSDS_TRACE_FILE");
+
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        for (i = 0; i < DATASET_STARVATION_TEST_NUM_BULK + 1; i++) {
+            H5Dclose(dset_ids[i]);
+            free(data[i]);
+            free(read_data[i]);
+        }
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (trace_file)
+        fclose(trace_file);
+    free(trace);
+    remove(DATASET_STARVATION_TEST_FILE);
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_worker_threads(void)
+{
+    const char     *num_threads[2] = { "0", DATASET_WORKER_THREADS_TEST_NUM_THREADS };
+    rv_mock_hsds_t *server = NULL;
+    unsigned short  port;
+    hsize_t         dims[2] = { DATASET_WORKER_THREADS_TEST_NUM_ROWS, DATASET_WORKER_THREADS_TEST_NUM_COLS };
+    hsize_t         mem_dims[2] = { DATASET_WORKER_THREADS_TEST_NUM_ROWS,
+                                    DATASET_WORKER_THREADS_TEST_NUM_COLS * DATASET_WORKER_THREADS_TEST_MEM_STRIDE };
+    hsize_t         start[2] = { 0, 0 };
+    hsize_t         stride[2] = { 1, DATASET_WORKER_THREADS_TEST_MEM_STRIDE };
+    hsize_t         count[2] = { DATASET_WORKER_THREADS_TEST_NUM_ROWS, DATASET_WORKER_THREADS_TEST_NUM_COLS };
+    size_t          nelmts = DATASET_WORKER_THREADS_TEST_NUM_ROWS * DATASET_WORKER_THREADS_TEST_NUM_COLS;
+    size_t          mem_nelmts = nelmts * DATASET_WORKER_THREADS_TEST_MEM_STRIDE;
+    size_t          i, k;
+    hid_t           file_id = -1, fapl_id = -1;
+    hid_t           dset_id = -1;
+    hid_t           fspace_id = -1;
+    hid_t           mspace_id = -1;
+    char            endpoints[ENDPOINTS_MAX_LENGTH];
+    char            dset_name[64];
+    long long      *wide_buf[2] = { NULL, NULL };
+    int            *read_buf[2] = { NULL, NULL };
+    int            *data = NULL;
+
+    TESTING("dataset I/O with and without worker threads")
+
+    if (NULL == (server = start_mock_server(NULL, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    /* The data is written from, and read back into, every other column of a
+     * buffer twice the width of the dataset
+     */
+    if (NULL == (data = (int *) malloc(mem_nelmts * sizeof(int))))
+        TEST_ERROR
+    for (i = 0; i < mem_nelmts; i++)
+        data[i] = (i % DATASET_WORKER_THREADS_TEST_MEM_STRIDE) ? -1 : (int) (i * 7 - nelmts);
+
+    if ((fspace_id = H5Screate_simple(2, dims, NULL)) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(2, mem_dims, NULL)) < 0)
+        TEST_ERROR
+    if (H5Sselect_hyperslab(mspace_id, H5S_SELECT_SET, start, stride, count, NULL) < 0)
+        TEST_ERROR
+
+    /* Write and read the same data with every conversion done inline and then
+     * shared out over the worker threads. Storing the data big-endian makes the
+     * plugin convert it in both directions, and there's enough of it for the
+     * work to be split up.
+     */
+    for (k = 0; k < 2; k++) {
+        if (setenv("HSDS_WORKER_THREADS", num_threads[k], 1) < 0)
+            TEST_ERROR
+
+        if (RVinit() < 0)
+            TEST_ERROR
+
+        if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+            TEST_ERROR
+        if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+            TEST_ERROR
+        if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+            TEST_ERROR
+
+        if (k)
+            file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id);
+        else
+            file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id);
+        if (file_id < 0) {
+            H5_FAILED();
+            printf("    couldn't %s file on mock server\n", k ? "open" : "create");
+            goto error;
+        }
+
+        snprintf(dset_name, sizeof(dset_name), DATASET_WORKER_THREADS_TEST_DSET_PREFIX "%zu", k);
+
+        if ((dset_id = H5Dcreate2(file_id, dset_name, H5T_STD_I32BE, fspace_id,
+                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't create dataset '%s'\n", dset_name);
+            goto error;
+        }
+
+        if (H5Dwrite(dset_id, H5T_NATIVE_INT, mspace_id, H5S_ALL, H5P_DEFAULT, data) < 0) {
+            H5_FAILED();
+            printf("    couldn't write to dataset with %s worker threads\n", num_threads[k]);
+            goto error;
+        }
+
+        if (NULL == (read_buf[k] = (int *) malloc(mem_nelmts * sizeof(int))))
+            TEST_ERROR
+        if (NULL == (wide_buf[k] = (long long *) malloc(nelmts * sizeof(long long))))
+            TEST_ERROR
+
+        for (i = 0; i < mem_nelmts; i++)
+            read_buf[k][i] = -1;
+
+        if (H5Dread(dset_id, H5T_NATIVE_INT, mspace_id, H5S_ALL, H5P_DEFAULT, read_buf[k]) < 0) {
+            H5_FAILED();
+            printf("    couldn't read from dataset with %s worker threads\n", num_threads[k]);
+            goto error;
+        }
+
+        if (H5Dread(dset_id, H5T_NATIVE_LLONG, H5S_ALL, H5S_ALL, H5P_DEFAULT, wide_buf[k]) < 0) {
+            H5_FAILED();
+            printf("    couldn't read from dataset as wider integers with %s worker threads\n", num_threads[k]);
+            goto error;
+        }
+
+        if (memcmp(read_buf[k], data, mem_nelmts * sizeof(int))) {
+            H5_FAILED();
+            printf("    wrong data read with %s worker threads\n", num_threads[k]);
+            goto error;
+        }
+
+        for (i = 0; i < nelmts; i++)
+            if (wide_buf[k][i] != (long long) data[i * DATASET_WORKER_THREADS_TEST_MEM_STRIDE]) {
+                H5_FAILED();
+                printf("    wrong data read as wider integers with %s worker threads\n", num_threads[k]);
+                goto error;
+            }
+
+        if (H5Dclose(dset_id) < 0)
+            TEST_ERROR
+        if (H5Pclose(fapl_id) < 0)
+            TEST_ERROR
+        if (H5Fclose(file_id) < 0)
+            TEST_ERROR
+        if (RVterm() < 0)
+            TEST_ERROR
+    }
+
+    if (unsetenv("HSDS_WORKER_THREADS") < 0)
+        TEST_ERROR
+
+    if (memcmp(read_buf[0], read_buf[1], mem_nelmts * sizeof(int))
+            || memcmp(wide_buf[0], wide_buf[1], nelmts * sizeof(long long))) {
+        H5_FAILED();
+        printf("    data read with and without worker threads differed\n");
+        goto error;
+    }
+
+    for (k = 0; k < 2; k++) {
+        free(read_buf[k]);
+        free(wide_buf[k]);
+    }
+    free(data);
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    unsetenv("HSDS_WORKER_THREADS");
+
+    for (k = 0; k < 2; k++) {
+        free(read_buf[k]);
+        free(wide_buf[k]);
+    }
+    free(data);
+
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_read_window(void)
+{
+    rv_mock_hsds_stats_t before, after;
+    rv_mock_hsds_t      *server = NULL;
+    unsigned short       port;
+    hsize_t              dims[2] = { DATASET_READ_WINDOW_TEST_NUM_ROWS, DATASET_READ_WINDOW_TEST_NUM_COLS };
+    hsize_t              start[2], stride[2], count[2];
+    hsize_t              mem_dims[1];
+    hsize_t              points[DATASET_READ_WINDOW_TEST_NUM_POINTS][2];
+    size_t               i, j, n;
+    hid_t                file_id = -1, fapl_id = -1;
+    hid_t                dset_id = -1;
+    hid_t                fspace_id = -1;
+    hid_t                sel_space_id = -1;
+    hid_t                mspace_id = -1;
+    hid_t                dxpl_id = -1, small_dxpl_id = -1;
+    char                 endpoints[ENDPOINTS_MAX_LENGTH];
+    int                  data[DATASET_READ_WINDOW_TEST_NUM_ROWS][DATASET_READ_WINDOW_TEST_NUM_COLS];
+    int                  read_buf[DATASET_READ_WINDOW_TEST_NUM_ROWS * DATASET_READ_WINDOW_TEST_NUM_COLS];
+
+    TESTING("dataset reads made in windows")
+
+    if (NULL == (server = start_mock_server(NULL, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    /* Use windows of 4KB, a small fraction of the dataset, and windows of
+     * 512 bytes, which are smaller than a row of the dataset
+     */
+    if ((dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+    if (H5Pset_dxpl_rest_vol_read_window(dxpl_id, DATASET_READ_WINDOW_TEST_WINDOW_SIZE, 2) < 0)
+        TEST_ERROR
+    if ((small_dxpl_id = H5Pcreate(H5P_DATASET_XFER)) < 0)
+        TEST_ERROR
+    if (H5Pset_dxpl_rest_vol_read_window(small_dxpl_id, DATASET_READ_WINDOW_TEST_SMALL_WINDOW, 0) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(2, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_READ_WINDOW_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_READ_WINDOW_TEST_NUM_ROWS; i++)
+        for (j = 0; j < DATASET_READ_WINDOW_TEST_NUM_COLS; j++)
+            data[i][j] = (int) (i * DATASET_READ_WINDOW_TEST_NUM_COLS + j);
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    /* The whole dataset, which takes 16 windows of 4 rows each */
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (rv_mock_hsds_get_stats(server, &before) < 0)
+        TEST_ERROR
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, dxpl_id, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read whole dataset in windows\n");
+        goto error;
+    }
+
+    if (rv_mock_hsds_get_stats(server, &after) < 0)
+        TEST_ERROR
+
+    if (after.num_requests - before.num_requests != 16) {
+        H5_FAILED();
+        printf("    whole dataset was read in %llu requests rather than 16 windows\n",
+                (unsigned long long) (after.num_requests - before.num_requests));
+        goto error;
+    }
+
+    if (memcmp(read_buf, data, sizeof(data))) {
+        H5_FAILED();
+        printf("    wrong data read from whole dataset in windows\n");
+        goto error;
+    }
+
+    /* A block of 40 rows of 200 elements, which isn't contiguous in the dataset.
+     * With 4KB windows it takes 8 windows of 5 rows each. With 512-byte windows,
+     * each row is split over two windows.
+     */
+    start[0] = 10; start[1] = 8;
+    count[0] = 40; count[1] = 200;
+    mem_dims[0] = count[0] * count[1];
+
+    if ((sel_space_id = H5Scopy(fspace_id)) < 0)
+        TEST_ERROR
+    if (H5Sselect_hyperslab(sel_space_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(1, mem_dims, NULL)) < 0)
+        TEST_ERROR
+
+    for (n = 0; n < 2; n++) {
+        size_t num_windows = n ? 80 : 8;
+
+        memset(read_buf, 0, sizeof(read_buf));
+
+        if (rv_mock_hsds_get_stats(server, &before) < 0)
+            TEST_ERROR
+
+        if (H5Dread(dset_id, H5T_NATIVE_INT, mspace_id, sel_space_id, n ? small_dxpl_id : dxpl_id, read_buf) < 0) {
+            H5_FAILED();
+            printf("    couldn't read block of dataset in windows\n");
+            goto error;
+        }
+
+        if (rv_mock_hsds_get_stats(server, &after) < 0)
+            TEST_ERROR
+
+        if (after.num_requests - before.num_requests != num_windows) {
+            H5_FAILED();
+            printf("    block of dataset was read in %llu requests rather than %zu windows\n",
+                    (unsigned long long) (after.num_requests - before.num_requests), num_windows);
+            goto error;
+        }
+
+        for (i = 0; i < count[0]; i++)
+            for (j = 0; j < count[1]; j++)
+                if (read_buf[i * count[1] + j] != data[start[0] + i][start[1] + j]) {
+                    H5_FAILED();
+                    printf("    wrong data read from block of dataset in windows of %d bytes\n",
+                            n ? DATASET_READ_WINDOW_TEST_SMALL_WINDOW : DATASET_READ_WINDOW_TEST_WINDOW_SIZE);
+                    goto error;
+                }
+    }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    mspace_id = -1;
+
+    /* Strided selections, and point selections, are larger than a window but
+     * are read in one go
+     */
+    start[0] = 1; start[1] = 3;
+    stride[0] = 4; stride[1] = 10;
+    count[0] = 15; count[1] = 25;
+    mem_dims[0] = count[0] * count[1];
+
+    if (H5Sselect_hyperslab(sel_space_id, H5S_SELECT_SET, start, stride, count, NULL) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(1, mem_dims, NULL)) < 0)
+        TEST_ERROR
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, mspace_id, sel_space_id, dxpl_id, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read strided hyperslab with a read window set\n");
+        goto error;
+    }
+
+    for (i = 0; i < count[0]; i++)
+        for (j = 0; j < count[1]; j++)
+            if (read_buf[i * count[1] + j] != data[start[0] + i * stride[0]][start[1] + j * stride[1]]) {
+                H5_FAILED();
+                printf("    wrong data read from strided hyperslab with a read window set\n");
+                goto error;
+            }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    mspace_id = -1;
+
+    for (i = 0; i < DATASET_READ_WINDOW_TEST_NUM_POINTS; i++) {
+        points[i][0] = (hsize_t) ((i * 7) % DATASET_READ_WINDOW_TEST_NUM_ROWS);
+        points[i][1] = (hsize_t) ((i * 13) % DATASET_READ_WINDOW_TEST_NUM_COLS);
+    }
+
+    mem_dims[0] = DATASET_READ_WINDOW_TEST_NUM_POINTS;
+
+    if (H5Sselect_elements(sel_space_id, H5S_SELECT_SET, DATASET_READ_WINDOW_TEST_NUM_POINTS, (const hsize_t *) points) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(1, mem_dims, NULL)) < 0)
+        TEST_ERROR
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, mspace_id, sel_space_id, small_dxpl_id, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read point selection with a read window set\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_READ_WINDOW_TEST_NUM_POINTS; i++)
+        if (read_buf[i] != data[points[i][0]][points[i][1]]) {
+            H5_FAILED();
+            printf("    wrong data read from point selection with a read window set\n");
+            goto error;
+        }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(sel_space_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(small_dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(dxpl_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(sel_space_id);
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(small_dxpl_id);
+        H5Pclose(dxpl_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_trace(void)
+{
+    rv_mock_hsds_t *server = NULL;
+    unsigned short  port;
+    hsize_t         dims[1] = { DATASET_TRACE_TEST_NUM_POINTS };
+    size_t          i;
+    long            trace_len;
+    hid_t           file_id = -1, fapl_id = -1;
+    hid_t           dset_id = -1;
+    hid_t           fspace_id = -1;
+    FILE           *trace_file = NULL;
+    char           *trace = NULL;
+    char           *event;
+    char           *event_end;
+    char            endpoints[ENDPOINTS_MAX_LENGTH];
+    int             data[DATASET_TRACE_TEST_NUM_POINTS];
+    int             read_buf[DATASET_TRACE_TEST_NUM_POINTS];
+    int             found_read = 0, found_get = 0;
+
+    TESTING("trace of dataset read written at termination")
+
+    if (NULL == (server = start_mock_server(NULL, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    /* Tracing is turned on at initialization */
+    remove(DATASET_TRACE_TEST_FILE);
+    if (setenv("HSDS_TRACE_FILE", DATASET_TRACE_TEST_FILE, 1) < 0)
+        TEST_ERROR
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_TRACE_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_TRACE_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    if (memcmp(read_buf, data, sizeof(data))) {
+        H5_FAILED();
+        printf("    data read from dataset didn't match\n");
+        goto error;
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (unsetenv("HSDS_TRACE_FILE") < 0)
+        TEST_ERROR
+
+    /* The trace is written out when the plugin is terminated */
+    if (NULL == (trace_file = fopen(DATASET_TRACE_TEST_FILE, "r"))) {
+        H5_FAILED();
+        printf("    trace file wasn't written\n");
+        goto error;
+    }
+
+    if (fseek(trace_file, 0, SEEK_END) < 0 || (trace_len = ftell(trace_file)) < 0 || fseek(trace_file, 0, SEEK_SET) < 0)
+        TEST_ERROR
+    if (NULL == (trace = (char *) malloc((size_t) trace_len + 1)))
+        TEST_ERROR
+    if (fread(trace, 1, (size_t) trace_len, trace_file) != (size_t) trace_len)
+        TEST_ERROR
+    trace[trace_len] = '\0';
+
+    fclose(trace_file);
+    trace_file = NULL;
+
+    if (strncmp(trace, "{\"displayTimeUnit\"", strlen("{\"displayTimeUnit\""))) {
+        H5_FAILED();
+        printf("    trace file isn't in the Chrome trace event format\n");
+        goto error;
+    }
+
+    /* Each event is written on a line of its own. The read should have been
+     * traced as a span for the VOL callback and as the GET of the dataset's
+     * values that it made.
+     */
+    for (event = strchr(trace, '\n'); event; event = event_end) {
+        event++;
+        if (NULL != (event_end = strchr(event, '\n')))
+            *event_end = '\0';
+
+        if (strstr(event, "\"name\": \"RV_dataset_read\"") && strstr(event, "\"cat\": \"vol\""))
+            found_read = 1;
+        else if (strstr(event, "\"name\": \"GET\"") && strstr(event, "/value\"") && strstr(event, "\"status\": 200"))
+            found_get = 1;
+    }
+
+    if (!found_read || !found_get) {
+        H5_FAILED();
+        printf("    trace is missing the %s of the dataset read\n", found_read ? "GET request" : "VOL callback");
+        goto error;
+    }
+
+    free(trace);
+    trace = NULL;
+
+    if (remove(DATASET_TRACE_TEST_FILE) < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    unsetenv("HSDS_TRACE_FILE");
+    if (trace_file)
+        fclose(trace_file);
+    free(trace);
+    remove(DATASET_TRACE_TEST_FILE);
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+/* Serves the plugin's requests in-process with the mock server's request
+ * handler. The previous response is kept until the next request, as the
+ * plugin requires.
+ */
+static rv_mock_hsds_response_t loopback_response;
+
+static herr_t
+loopback_handler(const rv_loopback_request_t *request, rv_loopback_response_t *response, void *handler_data)
+{
+    rv_mock_hsds_request_t mock_request;
+
+    rv_mock_hsds_free_response(&loopback_response);
+
+    memset(&mock_request, 0, sizeof(mock_request));
+    mock_request.method = request->method;
+    mock_request.path = request->path;
+    mock_request.query = request->query;
+    mock_request.domain = request->domain;
+    mock_request.content_type = request->content_type;
+    mock_request.body = request->body;
+    mock_request.body_len = request->body_len;
+
+    if (rv_mock_hsds_handle_request((rv_mock_hsds_t *) handler_data, &mock_request, &loopback_response) < 0)
+        return -1;
+
+    response->status = loopback_response.status;
+    response->content_type = loopback_response.content_type;
+    response->body = loopback_response.body;
+    response->body_len = loopback_response.body_len;
+
+    return 0;
+}
+
+static int
+test_dataset_loopback(void)
+{
+    rv_mock_hsds_stats_t server_stats;
+    rv_mock_hsds_t      *server = NULL;
+    rv_stats_t           stats;
+    hsize_t              dims[2] = { DATASET_LOOPBACK_TEST_NUM_ROWS, DATASET_LOOPBACK_TEST_NUM_COLS };
+    hsize_t              start[2] = { 4, 8 };
+    hsize_t              count[2] = { DATASET_LOOPBACK_TEST_NUM_ROWS / 2, DATASET_LOOPBACK_TEST_NUM_COLS / 2 };
+    size_t               i, j;
+    hid_t                file_id = -1, fapl_id = -1;
+    hid_t                dset_id = -1;
+    hid_t                fspace_id = -1;
+    hid_t                mspace_id = -1;
+    int                  data[DATASET_LOOPBACK_TEST_NUM_ROWS][DATASET_LOOPBACK_TEST_NUM_COLS];
+    int                  read_buf[DATASET_LOOPBACK_TEST_NUM_ROWS / 2][DATASET_LOOPBACK_TEST_NUM_COLS / 2];
+    int                  handler_set = 0;
+
+    TESTING("dataset I/O through an in-process loopback handler")
+
+    memset(&loopback_response, 0, sizeof(loopback_response));
+
+    /* The server is never started, so it can only be reached in-process */
+    if (NULL == (server = rv_mock_hsds_create(NULL))) {
+        H5_FAILED();
+        printf("    couldn't create mock server\n");
+        goto error;
+    }
+
+    if (RVset_loopback_handler(loopback_handler, server) < 0)
+        TEST_ERROR
+    handler_set = 1;
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file through loopback handler\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(2, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_LOOPBACK_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_LOOPBACK_TEST_NUM_ROWS; i++)
+        for (j = 0; j < DATASET_LOOPBACK_TEST_NUM_COLS; j++)
+            data[i][j] = (int) (i * DATASET_LOOPBACK_TEST_NUM_COLS + j);
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dopen2(file_id, DATASET_LOOPBACK_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    /* Read back a block from the middle of the dataset */
+    if (H5Sselect_hyperslab(fspace_id, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        TEST_ERROR
+    if ((mspace_id = H5Screate_simple(2, count, NULL)) < 0)
+        TEST_ERROR
+
+    memset(read_buf, 0, sizeof(read_buf));
+
+    if (H5Dread(dset_id, H5T_NATIVE_INT, mspace_id, fspace_id, H5P_DEFAULT, read_buf) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < count[0]; i++)
+        for (j = 0; j < count[1]; j++)
+            if (read_buf[i][j] != data[start[0] + i][start[1] + j]) {
+                H5_FAILED();
+                printf("    data read through loopback handler didn't match\n");
+                goto error;
+            }
+
+    /* Every request should have been served in-process without a connection */
+    if (RVget_stats(&stats) < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_get_stats(server, &server_stats) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < RV_REQUEST_NTYPES; i++)
+        if (stats.requests[i].num_connects) {
+            H5_FAILED();
+            printf("    a connection was made despite the loopback handler being set\n");
+            goto error;
+        }
+
+    if (server_stats.num_connections) {
+        H5_FAILED();
+        printf("    mock server accepted a connection\n");
+        goto error;
+    }
+
+    if (stats.requests[RV_REQUEST_DATASET_VALUE_GET].num_requests < 1
+            || stats.requests[RV_REQUEST_DATASET_VALUE_PUT].num_requests < 1) {
+        H5_FAILED();
+        printf("    dataset reads and writes weren't recorded as requests\n");
+        goto error;
+    }
+
+    if (H5Sclose(mspace_id) < 0)
+        TEST_ERROR
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+    if (RVset_loopback_handler(NULL, NULL) < 0)
+        TEST_ERROR
+
+    rv_mock_hsds_free_response(&loopback_response);
+
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(mspace_id);
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+        if (handler_set)
+            RVset_loopback_handler(NULL, NULL);
+    } H5E_END_TRY;
+
+    rv_mock_hsds_free_response(&loopback_response);
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_http2(void)
+{
+    rv_mock_hsds_config_t config;
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        port;
+    hsize_t               dims[1] = { DATASET_HTTP2_TEST_NUM_POINTS };
+    size_t                i, j;
+    herr_t                statuses[DATASET_HTTP2_TEST_NUM_DSETS];
+    herr_t                set_ret;
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_ids[DATASET_HTTP2_TEST_NUM_DSETS];
+    hid_t                 mem_type_ids[DATASET_HTTP2_TEST_NUM_DSETS];
+    hid_t                 space_ids[DATASET_HTTP2_TEST_NUM_DSETS];
+    hid_t                 fspace_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    char                  dset_name[64];
+    const void           *write_bufs[DATASET_HTTP2_TEST_NUM_DSETS];
+    void                 *read_bufs[DATASET_HTTP2_TEST_NUM_DSETS];
+    int                   data[DATASET_HTTP2_TEST_NUM_DSETS][DATASET_HTTP2_TEST_NUM_POINTS];
+    int                   read_data[DATASET_HTTP2_TEST_NUM_DSETS][DATASET_HTTP2_TEST_NUM_POINTS];
+
+    TESTING("concurrent dataset transfers with HTTP/2 requested")
+
+    for (i = 0; i < DATASET_HTTP2_TEST_NUM_DSETS; i++)
+        dset_ids[i] = -1;
+
+    /* The mock server only speaks plain HTTP/1.1, so asking for HTTP/2 should
+     * fall back to HTTP/1.1 without an upgrade. The server's latency makes
+     * the concurrent requests overlap, which has them wait to be multiplexed
+     * over a connection before opening more.
+     */
+    memset(&config, 0, sizeof(config));
+    config.latency_us = DATASET_HTTP2_TEST_LATENCY_US;
+
+    if (NULL == (server = start_mock_server(&config, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+
+    /* An unknown HTTP version should be refused rather than ignored */
+    if (setenv("HSDS_HTTP_VERSION", "3", 1) < 0)
+        TEST_ERROR
+
+    H5E_BEGIN_TRY {
+        set_ret = H5Pset_fapl_rest_vol(fapl_id);
+    } H5E_END_TRY;
+
+    if (set_ret >= 0) {
+        H5_FAILED();
+        printf("    set connection information with an unknown HTTP version\n");
+        goto error;
+    }
+
+    if (setenv("HSDS_HTTP_VERSION", "2", 1) < 0)
+        TEST_ERROR
+
+    H5E_BEGIN_TRY {
+        set_ret = H5Pset_fapl_rest_vol(fapl_id);
+    } H5E_END_TRY;
+
+    /* libcurl may have been built without HTTP/2 */
+    if (set_ret < 0) {
+        H5Pclose(fapl_id);
+        RVterm();
+        unsetenv("HSDS_HTTP_VERSION");
+        rv_mock_hsds_destroy(server);
+
+        SKIPPED();
+        printf("    libcurl has no HTTP/2 support\n");
+
+        return 0;
+    }
+
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < DATASET_HTTP2_TEST_NUM_DSETS; i++) {
+        snprintf(dset_name, sizeof(dset_name), DATASET_HTTP2_TEST_DSET_PREFIX "%zu", i);
+
+        if ((dset_ids[i] = H5Dcreate2(file_id, dset_name, H5T_NATIVE_INT, fspace_id,
+                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+            H5_FAILED();
+            printf("    couldn't create dataset '%s'\n", dset_name);
+            goto error;
+        }
+
+        for (j = 0; j < DATASET_HTTP2_TEST_NUM_POINTS; j++)
+            data[i][j] = (int) (i * DATASET_HTTP2_TEST_NUM_POINTS + j);
+
+        mem_type_ids[i] = H5T_NATIVE_INT;
+        space_ids[i] = H5S_ALL;
+        write_bufs[i] = data[i];
+        read_bufs[i] = read_data[i];
+    }
+
+    if (RVdataset_write_multi(DATASET_HTTP2_TEST_NUM_DSETS, dset_ids, mem_type_ids, space_ids, space_ids,
+            H5P_DEFAULT, write_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to multiple datasets\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_HTTP2_TEST_NUM_DSETS; i++)
+        if (statuses[i] < 0) {
+            H5_FAILED();
+            printf("    write to dataset %zu failed\n", i);
+            goto error;
+        }
+
+    memset(read_data, 0, sizeof(read_data));
+
+    if (RVdataset_read_multi(DATASET_HTTP2_TEST_NUM_DSETS, dset_ids, mem_type_ids, space_ids, space_ids,
+            H5P_DEFAULT, read_bufs, statuses) < 0) {
+        H5_FAILED();
+        printf("    couldn't read from multiple datasets\n");
+        goto error;
+    }
+
+    /* Each response must have been delivered to its own transfer */
+    for (i = 0; i < DATASET_HTTP2_TEST_NUM_DSETS; i++)
+        if (statuses[i] < 0 || memcmp(read_data[i], data[i], sizeof(data[i]))) {
+            H5_FAILED();
+            printf("    read from dataset %zu failed\n", i);
+            goto error;
+        }
+
+    for (i = 0; i < DATASET_HTTP2_TEST_NUM_DSETS; i++) {
+        if (H5Dclose(dset_ids[i]) < 0)
+            TEST_ERROR
+        dset_ids[i] = -1;
+    }
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    if (unsetenv("HSDS_HTTP_VERSION") < 0)
+        TEST_ERROR
+
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        for (i = 0; i < DATASET_HTTP2_TEST_NUM_DSETS; i++)
+            H5Dclose(dset_ids[i]);
+        H5Sclose(fspace_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    unsetenv("HSDS_HTTP_VERSION");
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_connection_reuse(void)
+{
+    rv_mock_hsds_stats_t server_stats;
+    rv_mock_hsds_t      *server = NULL;
+    rv_stats_t           stats;
+    unsigned short       port;
+    uint64_t             num_connections;
+    hsize_t              dims[1] = { DATASET_CONNECTION_REUSE_TEST_NUM_POINTS };
+    size_t               i;
+    herr_t               status;
+    hid_t                file_id = -1, fapl_id = -1;
+    hid_t                dset_id = -1;
+    hid_t                fspace_id = -1;
+    hid_t                mem_type_id = H5T_NATIVE_INT;
+    hid_t                space_id = H5S_ALL;
+    char                 endpoints[ENDPOINTS_MAX_LENGTH];
+    void                *read_buf_ptr;
+    int                  data[DATASET_CONNECTION_REUSE_TEST_NUM_POINTS];
+    int                  read_buf[DATASET_CONNECTION_REUSE_TEST_NUM_POINTS];
+
+    TESTING("reuse of connections after a file is reopened")
+
+    if (NULL == (server = start_mock_server(NULL, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol_endpoints(fapl_id, endpoints, RV_ENDPOINT_LEAST_OUTSTANDING) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_CONNECTION_REUSE_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_CONNECTION_REUSE_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    fspace_id = -1;
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    dset_id = -1;
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    file_id = -1;
+
+    if (rv_mock_hsds_get_stats(server, &server_stats) < 0)
+        TEST_ERROR
+    num_connections = server_stats.num_connections;
+
+    if (RVreset_stats() < 0)
+        TEST_ERROR
+
+    /* Reopening the file and reading the dataset, both with the main handle
+     * and with a handle duplicated for a concurrent transfer, should reuse
+     * the connections left open by the shared connection cache
+     */
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDONLY, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't reopen file\n");
+        goto error;
+    }
+
+    if ((dset_id = H5Dopen2(file_id, DATASET_CONNECTION_REUSE_TEST_DSET_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open dataset\n");
+        goto error;
+    }
+
+    memset(read_buf, 0, sizeof(read_buf));
+    read_buf_ptr = read_buf;
+
+    if (RVdataset_read_multi(1, &dset_id, &mem_type_id, &space_id, &space_id, H5P_DEFAULT,
+            &read_buf_ptr, &status) < 0 || status < 0) {
+        H5_FAILED();
+        printf("    couldn't read from dataset\n");
+        goto error;
+    }
+
+    if (memcmp(read_buf, data, sizeof(data))) {
+        H5_FAILED();
+        printf("    data read from reopened file didn't match\n");
+        goto error;
+    }
+
+    if (RVget_stats(&stats) < 0)
+        TEST_ERROR
+    if (rv_mock_hsds_get_stats(server, &server_stats) < 0)
+        TEST_ERROR
+
+    for (i = 0; i < RV_REQUEST_NTYPES; i++)
+        if (stats.requests[i].num_connects) {
+            H5_FAILED();
+            printf("    a new connection was made after reopening the file\n");
+            goto error;
+        }
+
+    if (server_stats.num_connections != num_connections) {
+        H5_FAILED();
+        printf("    mock server accepted %llu new connections after the file was reopened\n",
+                (unsigned long long) (server_stats.num_connections - num_connections));
+        goto error;
+    }
+
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    /* Terminating the plugin should release the share and with it close
+     * every pooled connection, which the server sees shortly after
+     */
+    for (i = 0; i < DATASET_CONNECTION_REUSE_TEST_CLOSE_MS; i += 10) {
+        if (rv_mock_hsds_get_stats(server, &server_stats) < 0)
+            TEST_ERROR
+        if (!server_stats.num_open_connections)
+            break;
+        usleep(10000);
+    }
+
+    if (server_stats.num_open_connections) {
+        H5_FAILED();
+        printf("    %llu connections were left open after the plugin was terminated\n",
+                (unsigned long long) server_stats.num_open_connections);
+        goto error;
+    }
+
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+
+static int
+test_dataset_changed_credentials(void)
+{
+    rv_mock_hsds_config_t config;
+    rv_mock_hsds_t       *server = NULL;
+    unsigned short        port;
+    hsize_t               dims[1] = { DATASET_CREDENTIALS_TEST_NUM_POINTS };
+    size_t                i;
+    herr_t                read_ret;
+    hid_t                 file_id = -1, fapl_id = -1;
+    hid_t                 dset_id = -1;
+    hid_t                 fspace_id = -1;
+    char                  endpoints[ENDPOINTS_MAX_LENGTH];
+    const char           *env_names[] = { "HSDS_ENDPOINT", "HSDS_USERNAME", "HSDS_PASSWORD" };
+    char                 *saved_env[] = { NULL, NULL, NULL };
+    const char           *env_val;
+    int                   data[DATASET_CREDENTIALS_TEST_NUM_POINTS];
+    int                   read_buf[DATASET_CREDENTIALS_TEST_NUM_POINTS];
+
+    TESTING("dataset reads after the credentials change")
+
+    /* The server only accepts requests made with the right credentials */
+    memset(&config, 0, sizeof(config));
+    config.authorization = DATASET_CREDENTIALS_TEST_AUTH;
+
+    if (NULL == (server = start_mock_server(&config, 1, &port, endpoints, sizeof(endpoints)))) {
+        H5_FAILED();
+        printf("    couldn't start mock server\n");
+        goto error;
+    }
+
+    /* The connection information is read from the environment each time a
+     * FAPL is set up, so point it at the mock server for the whole test
+     */
+    for (i = 0; i < sizeof(env_names) / sizeof(env_names[0]); i++)
+        if ((env_val = getenv(env_names[i])) && NULL == (saved_env[i] = strdup(env_val)))
+            TEST_ERROR
+
+    if (setenv("HSDS_ENDPOINT", endpoints, 1) < 0)
+        TEST_ERROR
+    if (setenv("HSDS_USERNAME", DATASET_CREDENTIALS_TEST_USERNAME, 1) < 0)
+        TEST_ERROR
+    if (setenv("HSDS_PASSWORD", DATASET_CREDENTIALS_TEST_PASSWORD, 1) < 0)
+        TEST_ERROR
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fcreate(filename, H5F_ACC_TRUNC, H5P_DEFAULT, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create file on mock server\n");
+        goto error;
+    }
+
+    if ((fspace_id = H5Screate_simple(1, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(file_id, DATASET_CREDENTIALS_TEST_DSET_NAME, H5T_NATIVE_INT,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_CREDENTIALS_TEST_NUM_POINTS; i++)
+        data[i] = (int) i;
+
+    if (H5Dwrite(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        H5_FAILED();
+        printf("    couldn't write to dataset\n");
+        goto error;
+    }
+
+    /* The headers kept for the file's requests must not hold on to the old
+     * credentials, so reads on the open dataset should fail once they are
+     * wrong and succeed again once they are put right
+     */
+    for (i = 0; i < 2; i++) {
+        if (setenv("HSDS_USERNAME", i ? DATASET_CREDENTIALS_TEST_USERNAME : DATASET_CREDENTIALS_TEST_BAD_USERNAME, 1) < 0)
+            TEST_ERROR
+        if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+            TEST_ERROR
+
+        memset(read_buf, 0, sizeof(read_buf));
+
+        H5E_BEGIN_TRY {
+            read_ret = H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, read_buf);
+        } H5E_END_TRY;
+
+        if (!i && read_ret >= 0) {
+            H5_FAILED();
+            printf("    read from dataset succeeded with the wrong credentials\n");
+            goto error;
+        }
+
+        if (i && (read_ret < 0 || memcmp(read_buf, data, sizeof(data)))) {
+            H5_FAILED();
+            printf("    read from dataset failed once the credentials were put right\n");
+            goto error;
+        }
+    }
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    for (i = 0; i < sizeof(env_names) / sizeof(env_names[0]); i++) {
+        if ((saved_env[i] ? setenv(env_names[i], saved_env[i], 1) : unsetenv(env_names[i])) < 0)
+            TEST_ERROR
+        free(saved_env[i]);
+        saved_env[i] = NULL;
+    }
+
+    if (rv_mock_hsds_destroy(server) < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Dclose(dset_id);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    for (i = 0; i < sizeof(env_names) / sizeof(env_names[0]); i++) {
+        if (saved_env[i])
+            setenv(env_names[i], saved_env[i], 1);
+        else
+            unsetenv(env_names[i]);
+        free(saved_env[i]);
+    }
+
+    if (server)
+        rv_mock_hsds_destroy(server);
+
+    return 1;
+}
+#endif
+
+static int
+test_unused_dataset_API_calls(void)
+{
+    H5D_space_status_t allocation;
+    hsize_t            dims[DATASET_UNUSED_APIS_TEST_SPACE_RANK];
+    size_t             i;
+    hid_t              file_id = -1, fapl_id = -1;
+    hid_t              container_group = -1;
+    hid_t              dset_id = -1;
+    hid_t              dset_dtype = -1;
+    hid_t              fspace_id = -1;
+
+    TESTING("unused dataset API calls")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_UNUSED_APIS_TEST_SPACE_RANK; i++)
+        dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
+
+    if ((fspace_id = H5Screate_simple(DATASET_UNUSED_APIS_TEST_SPACE_RANK, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_dtype = generate_random_datatype(H5T_NO_CLASS)) < 0)
+        TEST_ERROR
+
+    if ((dset_id = H5Dcreate2(container_group, DATASET_UNUSED_APIS_TEST_DSET_NAME, dset_dtype,
+            fspace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Testing that all of the unused dataset API calls don't cause application issues\n");
+#endif
+
+    H5E_BEGIN_TRY {
+        if (H5Dget_storage_size(dset_id) > 0)
+            TEST_ERROR
+        if (H5Dget_space_status(dset_id, &allocation) > 0)
+            TEST_ERROR
+        if (H5Dget_offset(dset_id) != HADDR_UNDEF)
+            TEST_ERROR
+    } H5E_END_TRY;
+
+    if (H5Sclose(fspace_id) < 0)
+        TEST_ERROR
+    if (H5Tclose(dset_dtype) < 0)
+        TEST_ERROR
+    if (H5Dclose(dset_id) < 0)
+        TEST_ERROR
+    if (H5Gclose(container_group) < 0)
+        TEST_ERROR
+    if (H5Pclose(fapl_id) < 0)
+        TEST_ERROR
+    if (H5Fclose(file_id) < 0)
+        TEST_ERROR
+    if (RVterm() < 0)
+        TEST_ERROR
+
+    PASSED();
+
+    return 0;
+
+error:
+    H5E_BEGIN_TRY {
+        H5Sclose(fspace_id);
+        H5Tclose(dset_dtype);
+        H5Dclose(dset_id);
+        H5Gclose(container_group);
+        H5Pclose(fapl_id);
+        H5Fclose(file_id);
+        RVterm();
+    } H5E_END_TRY;
+
+    return 1;
+}
+
+static int
+test_dataset_property_lists(void)
+{
+    const char *path_prefix = "/test_prefix";
+    hsize_t     dims[DATASET_PROPERTY_LIST_TEST_SPACE_RANK];
+    hsize_t     chunk_dims[DATASET_PROPERTY_LIST_TEST_SPACE_RANK];
+    size_t      i;
+    hid_t       file_id = -1, fapl_id = -1;
+    hid_t       container_group = -1, group_id = -1;
+    hid_t       dset_id1 = -1, dset_id2 = -1, dset_id3 = -1, dset_id4 = -1;
+    hid_t       dcpl_id1 = -1, dcpl_id2 = -1;
+    hid_t       dapl_id1 = -1, dapl_id2 = -1;
+    hid_t       dset_dtype1 = -1, dset_dtype2 = -1, dset_dtype3 = -1, dset_dtype4 = -1;
+    hid_t       space_id = -1;
+    char       *tmp_prefix = NULL;
+
+    TESTING("dataset property list operations")
+
+    if (RVinit() < 0)
+        TEST_ERROR
+
+    if ((fapl_id = H5Pcreate(H5P_FILE_ACCESS)) < 0)
+        TEST_ERROR
+    if (H5Pset_fapl_rest_vol(fapl_id) < 0)
+        TEST_ERROR
+
+    if ((file_id = H5Fopen(filename, H5F_ACC_RDWR, fapl_id)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open file\n");
+        goto error;
+    }
+
+    if ((container_group = H5Gopen2(file_id, DATASET_TEST_GROUP_NAME, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't open container group\n");
+        goto error;
+    }
+
+    if ((group_id = H5Gcreate2(container_group, DATASET_PROPERTY_LIST_TEST_SUBGROUP_NAME, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create container sub-group\n");
+        goto error;
+    }
+
+    for (i = 0; i < DATASET_PROPERTY_LIST_TEST_SPACE_RANK; i++)
+        dims[i] = (hsize_t) (rand() % MAX_DIM_SIZE + 1);
+    for (i = 0; i < DATASET_PROPERTY_LIST_TEST_SPACE_RANK; i++)
+        chunk_dims[i] = (hsize_t) (rand() % (int) dims[i] + 1);
+
+    if ((space_id = H5Screate_simple(DATASET_PROPERTY_LIST_TEST_SPACE_RANK, dims, NULL)) < 0)
+        TEST_ERROR
+
+    if ((dset_dtype1 = generate_random_datatype(H5T_NO_CLASS)) < 0)
+        TEST_ERROR
+    if ((dset_dtype2 = generate_random_datatype(H5T_NO_CLASS)) < 0)
+        TEST_ERROR
+    if ((dset_dtype3 = generate_random_datatype(H5T_NO_CLASS)) < 0)
+        TEST_ERROR
+    if ((dset_dtype4 = generate_random_datatype(H5T_NO_CLASS)) < 0)
+        TEST_ERROR
+
+    if ((dcpl_id1 = H5Pcreate(H5P_DATASET_CREATE)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create DCPL\n");
+        goto error;
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Setting property on DCPL\n");
+#endif
+
+    if (H5Pset_chunk(dcpl_id1, DATASET_PROPERTY_LIST_TEST_SPACE_RANK, chunk_dims) < 0) {
+        H5_FAILED();
+        printf("    couldn't set DCPL property\n");
+        goto error;
+    }
+
+    if ((dset_id1 = H5Dcreate2(group_id, DATASET_PROPERTY_LIST_TEST_DSET_NAME1, dset_dtype1,
+            space_id, H5P_DEFAULT, dcpl_id1, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    if ((dset_id2 = H5Dcreate2(group_id, DATASET_PROPERTY_LIST_TEST_DSET_NAME2, dset_dtype2,
+            space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create dataset\n");
+        goto error;
+    }
+
+    if (H5Pclose(dcpl_id1) < 0)
+        TEST_ERROR
+
+    /* Try to receive copies of the two property lists, one which has the property set and one which does not */
+    if ((dcpl_id1 = H5Dget_create_plist(dset_id1)) < 0) {
+        H5_FAILED();
+        printf("    couldn't get property list\n");
+        goto error;
+    }
+
+    if ((dcpl_id2 = H5Dget_create_plist(dset_id2)) < 0) {
+        H5_FAILED();
+        printf("    couldn't get property list\n");
+        goto error;
+    }
+
+    /* Ensure that property list 1 has the property set and property list 2 does not */
+    {
+        hsize_t tmp_chunk_dims[DATASET_PROPERTY_LIST_TEST_SPACE_RANK];
+
+        memset(tmp_chunk_dims, 0, sizeof(tmp_chunk_dims));
+
+        if (H5Pget_chunk(dcpl_id1, DATASET_PROPERTY_LIST_TEST_SPACE_RANK, tmp_chunk_dims) < 0) {
+            H5_FAILED();
+            printf("    couldn't get DCPL property value\n");
+            goto error;
+        }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Ensuring that the property on the DCPL was received back correctly\n");
+#endif
+
+        for (i = 0; i < DATASET_PROPERTY_LIST_TEST_SPACE_RANK; i++)
+            if (tmp_chunk_dims[i] != chunk_dims[i]) {
+                H5_FAILED();
+                printf("    DCPL property values were incorrect\n");
+                goto error;
+            }
+
+        H5E_BEGIN_TRY {
+            if (H5Pget_chunk(dcpl_id2, DATASET_PROPERTY_LIST_TEST_SPACE_RANK, tmp_chunk_dims) >= 0) {
+                H5_FAILED();
+                printf("    property list 2 shouldn't have had chunk dimensionality set (not a chunked layout)\n");
+                goto error;
+            }
+        } H5E_END_TRY;
+    }
+
+    if ((dapl_id1 = H5Pcreate(H5P_DATASET_ACCESS)) < 0) {
+        H5_FAILED();
+        printf("    couldn't create DAPL\n");
+        goto error;
+    }
+
+#ifdef RV_PLUGIN_DEBUG
+    puts("Setting property on DAPL\n");
+#endif
 
     if (H5Pset_efile_prefix(dapl_id1, path_prefix) < 0) {
         H5_FAILED();
@@ -14709,7 +19007,7 @@ test_create_obj_ref(void)
 
     if (H5R_OBJECT != ref.ref_type) TEST_ERROR
     if (H5I_GROUP != ref.ref_obj_type) TEST_ERROR
-    if (strcmp(RVget_uri(file_id), ref.ref_obj_URI)) TEST_ERROR
+    if (strcmp(RVget_uri(file_id), RVget_ref_uri(&ref))) TEST_ERROR
 
     if (H5Pclose(fapl_id) < 0)
         TEST_ERROR
@@ -15104,7 +19402,7 @@ test_write_dataset_w_obj_refs(void)
                 TEST_ERROR
         }
 
-        if (strcmp(URI, ref_array[i].ref_obj_URI)) {
+        if (strcmp(URI, RVget_ref_uri(&ref_array[i]))) {
             H5_FAILED();
             printf("    ref type had mismatched URI\n");
             goto error;
@@ -15310,7 +19608,7 @@ test_read_dataset_w_obj_refs(void)
                 TEST_ERROR
         }
 
-        if (strcmp(URI, ref_array[i].ref_obj_URI)) {
+        if (strcmp(URI, RVget_ref_uri(&ref_array[i]))) {
             H5_FAILED();
             printf("    ref type had mismatched URI\n");
             goto error;
@@ -15368,10 +19666,10 @@ test_read_dataset_w_obj_refs(void)
          * the server spec where each URI is prefixed as
          * 'X-', where X is a character denoting the type
          * of object */
-        if (   (ref_array[i].ref_obj_URI[1] != '-')
-            || (ref_array[i].ref_obj_URI[0] != 'g'
-            &&  ref_array[i].ref_obj_URI[0] != 't'
-            &&  ref_array[i].ref_obj_URI[0] != 'd')
+        if (   (RVget_ref_uri(&ref_array[i])[1] != '-')
+            || (RVget_ref_uri(&ref_array[i])[0] != 'g'
+            &&  RVget_ref_uri(&ref_array[i])[0] != 't'
+            &&  RVget_ref_uri(&ref_array[i])[0] != 'd')
            ) {
             H5_FAILED();
             printf("    ref URI mismatch\n");
@@ -15499,7 +19797,7 @@ test_write_dataset_w_obj_refs_empty_data(void)
                 if (NULL == (URI = RVget_uri(file_id)))
                     TEST_ERROR
 
-                if (strcmp(URI, ref_array[i].ref_obj_URI)) {
+                if (strcmp(URI, RVget_ref_uri(&ref_array[i]))) {
                     H5_FAILED();
                     printf("    ref type had mismatched URI\n");
                     goto error;
@@ -17521,6 +21819,72 @@ error:
     return datatype;
 }
 
+/* Helper function to remove a disk cache directory created by a test, along
+ * with the cache entries in it
+ */
+static herr_t
+remove_disk_cache_dir(const char *dir)
+{
+#ifndef WIN32
+    struct dirent *entry;
+    DIR           *dirp;
+    char           path[1024];
+
+    if (NULL == (dirp = opendir(dir)))
+        return 0;
+
+    while ((entry = readdir(dirp))) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        unlink(path);
+    }
+
+    closedir(dirp);
+
+    if (rmdir(dir) < 0)
+        return -1;
+#endif
+
+    return 0;
+}
+
+#ifndef WIN32
+/* Helper function to start an in-process mock HSDS server listening on the
+ * given number of ports, for tests which need to control how the server
+ * behaves. The ports are returned along with the list of the server's
+ * endpoints, as given to H5Pset_fapl_rest_vol_endpoints().
+ */
+static rv_mock_hsds_t *
+start_mock_server(const rv_mock_hsds_config_t *config, size_t num_ports, unsigned short ports[],
+                  char *endpoints, size_t endpoints_size)
+{
+    rv_mock_hsds_t *server;
+    size_t          len = 0;
+    size_t          i;
+
+    if (NULL == (server = rv_mock_hsds_create(config)))
+        return NULL;
+
+    for (i = 0; i < num_ports; i++) {
+        if (rv_mock_hsds_start(server, 0, &ports[i]) < 0)
+            goto error;
+
+        len += (size_t) snprintf(endpoints + len, endpoints_size - len, "%shttp://127.0.0.1:%u", i ? "," : "", (unsigned) ports[i]);
+        if (len >= endpoints_size)
+            goto error;
+    }
+
+    return server;
+
+error:
+    rv_mock_hsds_destroy(server);
+
+    return NULL;
+}
+#endif
+
 int
 main( int argc, char** argv )
 {